@@ -0,0 +1,212 @@
+#include "DiskDifficulty.h"
+
+// ── Rolling window ───────────────────────────────────────────────────────────
+
+void FDiskRollingWindow::Reset()
+{
+    Sum   = 0.0;
+    Count = 0;
+    Next  = 0;
+}
+
+void FDiskRollingWindow::Add(float Value)
+{
+    if (Count == Capacity)
+        Sum -= Samples[Next];
+    else
+        ++Count;
+
+    Samples[Next] = Value;
+    Sum += Value;
+    Next = (Next + 1) % Capacity;
+
+    // Once per lap, so still O(1) per sample on average.
+    if (Next == 0)
+    {
+        Sum = 0.0;
+        for (const float Sample : Samples) Sum += Sample;
+    }
+}
+
+void FDiskRollingWindow::Serialize(FArchive& Ar)
+{
+    Ar << Count << Next;
+    Ar.Serialize(Samples, sizeof(Samples));
+    if (Ar.IsLoading())
+    {
+        if (Count < 0 || Count > Capacity || Next < 0 || Next >= Capacity)
+        {
+            Ar.SetError();
+            Reset();
+            return;
+        }
+        Sum = 0.0;
+        for (int32 i = 0; i < Count; ++i)
+            Sum += Samples[(Next - Count + i + Capacity) % Capacity];
+    }
+}
+
+// ── Controller ───────────────────────────────────────────────────────────────
+
+void FDiskDifficulty::Reset(int32 NumCells)
+{
+    CellScales.Init(1.f, NumCells);
+    ClimbWindow.Reset();
+    AccuracyWindow.Reset();
+    FallWindow.Reset();
+    Tracks.Reset();
+
+    TargetScale    = 1.f;
+    LastSampleTime = 0.0;
+    PendingFalls   = 0;
+    bStarted       = false;
+}
+
+void FDiskDifficulty::TrackPlayer(int32 Slot, double Z)
+{
+    if (!Config.bEnabled || Slot < 0) return;
+
+    if (Tracks.Num() <= Slot) Tracks.SetNum(Slot + 1);
+    FPlayerTrack& Track = Tracks[Slot];
+    if (!Track.bActive && !Track.bSampled)
+        Track.PeakZ = Z;   // First sight of this player
+
+    Track.Z       = Z;
+    Track.bActive = true;
+
+    // Knockbacks and missed jumps both show up as the height dropping well below the last peak.
+    if (Z < Track.PeakZ - Config.FallHeight)
+    {
+        ++PendingFalls;
+        Track.PeakZ = Z;
+    }
+    Track.PeakZ = FMath::Max(Track.PeakZ, Z);
+}
+
+void FDiskDifficulty::ReleasePlayer(int32 Slot)
+{
+    if (Tracks.IsValidIndex(Slot))
+        Tracks[Slot] = FPlayerTrack();
+}
+
+void FDiskDifficulty::Advance(double Now)
+{
+    if (!Config.bEnabled) return;
+
+    if (!bStarted)
+    {
+        LastSampleTime = Now;
+        bStarted       = true;
+    }
+
+    const double Elapsed = Now - LastSampleTime;
+    if (Elapsed < FMath::Max(Config.SampleInterval, UE_KINDA_SMALL_NUMBER)) return;
+
+    // Players present for the whole sample contribute their climb; the rest only start one.
+    double ClimbSum   = 0.0;
+    int32  NumClimbed = 0;
+    for (FPlayerTrack& Track : Tracks)
+    {
+        if (!Track.bActive)
+        {
+            Track.bSampled = false;
+            continue;
+        }
+        if (Track.bSampled)
+        {
+            ClimbSum += (Track.Z - Track.SampleZ) / Elapsed;
+            ++NumClimbed;
+        }
+        Track.SampleZ  = Track.Z;
+        Track.bSampled = true;
+        Track.bActive  = false;
+    }
+
+    if (NumClimbed > 0)
+        ClimbWindow.Add(static_cast<float>(ClimbSum / NumClimbed));
+    FallWindow.Add(static_cast<float>(PendingFalls));
+    PendingFalls   = 0;
+    LastSampleTime = Now;
+
+    Retarget();
+}
+
+void FDiskDifficulty::AddShot(int32 Cell, bool bHit)
+{
+    if (!Config.bEnabled) return;
+
+    AccuracyWindow.Add(bHit ? 1.f : 0.f);
+
+    // The cells players are using get a little harder straight away.
+    if (bHit && CellScales.IsValidIndex(Cell))
+        CellScales[Cell] = FMath::Min(CellScales[Cell] * (1.f + Config.HitNudge), Config.MaxScale);
+}
+
+void FDiskDifficulty::OnRespawn(int32 Cell)
+{
+    if (!Config.bEnabled || !CellScales.IsValidIndex(Cell)) return;
+
+    float& Scale = CellScales[Cell];
+    Scale += Config.CellBlend * (TargetScale - Scale);
+}
+
+float FDiskDifficulty::GetFallsPerMinute() const
+{
+    const double Seconds = FallWindow.Num() * FMath::Max(Config.SampleInterval, UE_KINDA_SMALL_NUMBER);
+    return Seconds > 0.0 ? static_cast<float>(FallWindow.GetSum() * 60.0 / Seconds) : 0.f;
+}
+
+void FDiskDifficulty::Retarget()
+{
+    // Each metric's error is normalized to [-1, 1]: positive means the players find the field
+    // too easy. Metrics without data yet are left out.
+    float Error    = 0.f;
+    int32 NumTerms = 0;
+
+    if (ClimbWindow.Num() > 0 && Config.TargetClimbRate > 0.f)
+    {
+        Error += FMath::Clamp(GetClimbRate() / Config.TargetClimbRate - 1.f, -1.f, 1.f);
+        ++NumTerms;
+    }
+    if (AccuracyWindow.Num() > 0 && Config.TargetAccuracy > 0.f)
+    {
+        Error += FMath::Clamp(GetAccuracy() / Config.TargetAccuracy - 1.f, -1.f, 1.f);
+        ++NumTerms;
+    }
+    if (FallWindow.Num() > 0 && Config.TargetFallsPerMinute > 0.f)
+    {
+        Error += FMath::Clamp(1.f - GetFallsPerMinute() / Config.TargetFallsPerMinute, -1.f, 1.f);
+        ++NumTerms;
+    }
+    if (NumTerms == 0) return;
+
+    // Multiplicative, so the scale keeps moving until the players are on target.
+    TargetScale *= 1.f + Config.AdjustRate * Error / NumTerms;
+    TargetScale  = FMath::Clamp(TargetScale, Config.MinScale, FMath::Max(Config.MinScale, Config.MaxScale));
+}
+
+void FDiskDifficulty::Serialize(FArchive& Ar)
+{
+    Ar << Config.bEnabled << Config.TargetClimbRate << Config.TargetAccuracy << Config.TargetFallsPerMinute;
+    Ar << Config.FallHeight << Config.SampleInterval << Config.AdjustRate << Config.MinScale << Config.MaxScale;
+    Ar << Config.CellBlend << Config.HitNudge;
+
+    Ar << CellScales << TargetScale << LastSampleTime << PendingFalls << bStarted;
+    ClimbWindow.Serialize(Ar);
+    AccuracyWindow.Serialize(Ar);
+    FallWindow.Serialize(Ar);
+
+    int32 NumTracks = Tracks.Num();
+    Ar << NumTracks;
+    if (Ar.IsLoading())
+    {
+        if (NumTracks < 0)
+        {
+            Ar.SetError();
+            return;
+        }
+        Tracks.SetNum(NumTracks);
+    }
+    for (FPlayerTrack& Track : Tracks)
+        Ar << Track.Z << Track.SampleZ << Track.PeakZ << Track.bActive << Track.bSampled;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Tuning for FDiskDifficulty; ADiskSpawner copies its Difficulty UPROPERTYs in here. */
+struct FDiskDifficultyConfig
+{
+    bool  bEnabled             = false;
+    float TargetClimbRate      = 60.f;    // Height gained per second (UU/s) the field aims for
+    float TargetAccuracy       = 0.5f;    // Share of shots that freeze a disk
+    float TargetFallsPerMinute = 2.f;
+    float FallHeight           = 300.f;   // A drop this far below a player's last peak counts as a fall
+    float SampleInterval       = 1.f;     // Seconds of simulation per climb/fall sample
+    float AdjustRate           = 0.05f;   // Largest change of the target scale per sample, as a fraction
+    float MinScale             = 0.5f;
+    float MaxScale             = 2.f;
+    float CellBlend            = 0.5f;    // Share of the gap to the target scale a cell closes on each respawn
+    float HitNudge             = 0.05f;   // Extra speed a cell gets each time a player freezes its disk
+};
+
+/**
+ * Mean of the last Capacity samples. Adding one replaces the oldest and updates a running sum,
+ * so it is O(1); the sum is recomputed each time the ring wraps so rounding never builds up.
+ */
+struct FDiskRollingWindow
+{
+    static constexpr int32 Capacity = 64;
+
+    void Reset();
+    void Add(float Value);
+
+    int32  Num() const    { return Count; }
+    double GetSum() const { return Sum; }
+    float  Mean(float Fallback) const { return Count > 0 ? static_cast<float>(Sum / Count) : Fallback; }
+
+    void Serialize(FArchive& Ar);
+
+private:
+    float  Samples[Capacity] = {};
+    double Sum   = 0.0;
+    int32  Count = 0;
+    int32  Next  = 0;
+};
+
+/**
+ * Online difficulty controller for the disk field. Streams the players' climb rate, shot
+ * accuracy and fall frequency into fixed-size rolling windows and steers a target speed scale
+ * towards the configured targets: players beating them get faster disks, players missing them
+ * slower ones.
+ *
+ * The scale is applied per cell. A cell moves part of the way to the target each time it
+ * respawns and speeds up a little each time a player freezes its disk, so every event costs
+ * O(1) and the distribution shifts gradually instead of in one sweep over the grid.
+ *
+ * Plain data with no UObject dependency. FDiskSimulation owns one, feeds it from Tick, HitDisk
+ * and MissShot and saves it with its state, so recorded sessions replay with the same tuning
+ * and the controller can be run offline on replays or synthetic players.
+ */
+struct STACKOBOT_API FDiskDifficulty
+{
+    FDiskDifficultyConfig Config;
+    TArray<float>         CellScales;   // Per grid cell: multiplier on the random speed of its disks
+
+    /** Forget every measurement and set NumCells cells to scale 1. The config is kept. */
+    void Reset(int32 NumCells);
+
+    /** Per simulation step, for each player: watch the height for falls and the next climb sample. */
+    void TrackPlayer(int32 Slot, double Z);
+
+    /** The player in Slot left; a new player in it starts a fresh track. */
+    void ReleasePlayer(int32 Slot);
+
+    /** Per simulation step, after TrackPlayer: take a climb/fall sample and retarget once SampleInterval has passed. */
+    void Advance(double Now);
+
+    /** A shot resolved: bHit if it froze the disk in Cell. */
+    void AddShot(int32 Cell, bool bHit);
+
+    /** The disk in Cell respawned: close part of the cell's gap to the target scale. */
+    void OnRespawn(int32 Cell);
+
+    float GetCellScale(int32 Cell) const
+    {
+        return Config.bEnabled && CellScales.IsValidIndex(Cell) ? CellScales[Cell] : 1.f;
+    }
+
+    float GetTargetScale() const    { return TargetScale; }
+    float GetClimbRate() const      { return ClimbWindow.Mean(0.f); }
+    float GetAccuracy() const       { return AccuracyWindow.Mean(0.f); }
+    float GetFallsPerMinute() const;
+
+    void Serialize(FArchive& Ar);
+
+private:
+    struct FPlayerTrack
+    {
+        double Z        = 0.0;     // Latest height
+        double SampleZ  = 0.0;     // Height at the last climb sample
+        double PeakZ    = 0.0;     // Highest point since the last fall
+        bool   bActive  = false;   // Seen since the last sample
+        bool   bSampled = false;   // SampleZ is valid
+    };
+
+    FDiskRollingWindow   ClimbWindow;      // Mean climb rate of the players, one entry per sample
+    FDiskRollingWindow   AccuracyWindow;   // 1 per hit, 0 per miss
+    FDiskRollingWindow   FallWindow;       // Falls per sample
+    TArray<FPlayerTrack> Tracks;           // Per player slot
+
+    float  TargetScale    = 1.f;
+    double LastSampleTime = 0.0;
+    int32  PendingFalls   = 0;   // Falls since the last sample
+    bool   bStarted       = false;
+
+    /** Nudge TargetScale by the windows' average error against the targets. */
+    void Retarget();
+};
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "DiskFieldBenchmarkCommandlet.h"
+#include "DiskSimulation.h"
+#include "DiskRandom.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    constexpr float BenchDeltaTime   = 1.f / 60.f;
+    constexpr int32 BenchWarmupTicks = 60;
+    constexpr int32 BenchHitsPerTick = 2;
+
+    /** Synthetic player: climbs 150 UU/s and drops back to the ground every 2000 UU, each slot phase-shifted. */
+    float BenchPlayerZ(double Time, int32 Slot)
+    {
+        return static_cast<float>(FMath::Fmod(Time * 150.0 + Slot * 277.0, 2000.0));
+    }
+
+    /** One simulated frame: the rules tick plus a couple of laser hits and a miss, like ADiskSpawner::Tick. */
+    void BenchTick(FDiskSimulation& Sim, uint32 Seed, uint32 Frame, TArray<FDiskPlayer>& Players)
+    {
+        for (FDiskPlayer& Player : Players)
+            Player.Z = BenchPlayerZ(Sim.SimTime, Player.Slot);
+        Sim.Tick(BenchDeltaTime, Players);
+
+        for (int32 Hit = 0; Hit < BenchHitsPerTick; ++Hit)
+        {
+            const uint64 Bits = FDiskRandom::Bits(Seed, Frame, Hit);
+            const FDiskPlayer& Shooter = Players[(Frame * BenchHitsPerTick + Hit) % Players.Num()];
+            Sim.HitDisk(static_cast<int32>(Bits % Sim.Num()), Shooter.Z, Shooter.Slot);
+        }
+        Sim.MissShot();
+
+        Sim.Events.Reset();   // The spawner would mirror these onto actors here
+    }
+}
+
+UDiskFieldBenchmarkCommandlet::UDiskFieldBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+    HelpDescription = TEXT("Benchmarks the headless disk-field simulation at grid sizes 4x4 .. MaxSize x MaxSize.");
+    HelpUsage = TEXT("-run=DiskFieldBenchmark -nullrhi [-Ticks=600] [-MaxSize=512] [-Seed=1] [-Players=1] [-Difficulty]");
+}
+
+int32 UDiskFieldBenchmarkCommandlet::Main(const FString& Params)
+{
+    int32 Ticks      = 600;
+    int32 MaxSize    = 512;
+    int32 Seed       = 1;
+    int32 NumPlayers = 1;
+    FParse::Value(*Params, TEXT("Ticks="), Ticks);
+    FParse::Value(*Params, TEXT("MaxSize="), MaxSize);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("Players="), NumPlayers);
+    Ticks      = FMath::Max(1, Ticks);
+    NumPlayers = FMath::Max(1, NumPlayers);
+    const bool bDifficulty = FParse::Param(*Params, TEXT("Difficulty"));
+
+    TArray<FDiskPlayer> Players;
+    for (int32 Slot = 0; Slot < NumPlayers; ++Slot)
+        Players.Add({ Slot, 0.f });
+
+    FString Csv = TEXT("Columns,Rows,Disks,Players,Ticks,NsPerTick,NsPerDiskTick\n");
+    UE_LOG(LogTemp, Display, TEXT("DiskFieldBenchmark: %d ticks per size, %d players, seed %d"), Ticks, NumPlayers, Seed);
+
+    for (int32 Size = 4; Size <= MaxSize; Size *= 2)
+    {
+        const int32 NumDisks = Size * Size;
+
+        FDiskSimulation Sim;
+        Sim.Config.Seed = static_cast<uint32>(Seed);
+        Sim.Difficulty.Config.bEnabled = bDifficulty;
+        Sim.Reset(NumDisks);
+
+        // Stagger the starting heights so respawns spread over time as they do in play.
+        for (int32 i = 0; i < NumDisks; ++i)
+        {
+            const float Z = Sim.Config.SpawnHeightOffset * FDiskRandom::Unit(FDiskRandom::Bits(Sim.Config.Seed, i, ~0u));
+            Sim.Spawn(i, Z, Sim.RandomSpeed(i));
+        }
+
+        uint32 Frame = 0;
+        for (int32 i = 0; i < BenchWarmupTicks; ++i)
+            BenchTick(Sim, Sim.Config.Seed, Frame++, Players);
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 i = 0; i < Ticks; ++i)
+            BenchTick(Sim, Sim.Config.Seed, Frame++, Players);
+        const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        const double NsPerTick = Seconds * 1e9 / Ticks;
+        const double NsPerDisk = NsPerTick / NumDisks;
+
+        UE_LOG(LogTemp, Display, TEXT("DiskFieldBenchmark: %4dx%-4d %7d disks  %12.0f ns/tick  %7.2f ns/disk"),
+            Size, Size, NumDisks, NsPerTick, NsPerDisk);
+        Csv += FString::Printf(TEXT("%d,%d,%d,%d,%d,%.0f,%.3f\n"), Size, Size, NumDisks, NumPlayers, Ticks, NsPerTick, NsPerDisk);
+
+        if (bDifficulty)
+        {
+            const FDiskDifficulty& Difficulty = Sim.Difficulty;
+            UE_LOG(LogTemp, Display, TEXT("DiskFieldBenchmark:   difficulty scale %.3f  climb %.1f UU/s  accuracy %.0f%%  %.1f falls/min"),
+                Difficulty.GetTargetScale(), Difficulty.GetClimbRate(), Difficulty.GetAccuracy() * 100.f, Difficulty.GetFallsPerMinute());
+        }
+    }
+
+    const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("DiskFieldBenchmark.csv");
+    FFileHelper::SaveStringToFile(Csv, *CsvPath);
+    UE_LOG(LogTemp, Display, TEXT("DiskFieldBenchmark: wrote %s"), *CsvPath);
+
+    return 0;
+}
\ No newline at end of file
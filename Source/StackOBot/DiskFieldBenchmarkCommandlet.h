@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DiskFieldBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the headless FDiskSimulation at square grid sizes from 4x4 up to MaxSize and reports
+ * ns per simulated tick, so rule changes show up as numbers without launching the editor:
+ *
+ *   UnrealEditor-Cmd StackOBot.uproject -run=DiskFieldBenchmark -nullrhi [-Ticks=600] [-MaxSize=512] [-Seed=1] [-Players=1] [-Difficulty]
+ *
+ * -Players runs that many synthetic climbers at staggered heights, each shooting in turn.
+ * -Difficulty turns on the FDiskDifficulty controller, timing it and logging where it tuned
+ * the field for the synthetic players.
+ *
+ * Results are logged and written to Saved/Profiling/DiskFieldBenchmark.csv.
+ */
+UCLASS()
+class STACKOBOT_API UDiskFieldBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UDiskFieldBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
\ No newline at end of file
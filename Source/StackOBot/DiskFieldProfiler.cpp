@@ -0,0 +1,138 @@
+#include "DiskFieldProfiler.h"
+
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_DiskField_SpawnerTick);
+DEFINE_STAT(STAT_DiskField_SimulationTick);
+DEFINE_STAT(STAT_DiskField_ApplyEvents);
+DEFINE_STAT(STAT_DiskField_Significance);
+DEFINE_STAT(STAT_DiskField_PushTransforms);
+DEFINE_STAT(STAT_DiskField_TopUpPool);
+DEFINE_STAT(STAT_DiskField_UpdateHUD);
+DEFINE_STAT(STAT_DiskField_Fire);
+DEFINE_STAT(STAT_DiskField_FireTrace);
+DEFINE_STAT(STAT_DiskField_FireBeam);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Respawns / s"), STAT_DiskField_RespawnRate, STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Shots / s"),    STAT_DiskField_ShotRate,    STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Hits / s"),     STAT_DiskField_HitRate,     STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Net Updates / s"), STAT_DiskField_NetUpdateRate, STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("State Updates / s"), STAT_DiskField_StateUpdateRate, STATGROUP_StackOBot);
+
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_RespawnRate, TEXT("StackOBot/Respawns per second"));
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_ShotRate,    TEXT("StackOBot/Shots per second"));
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_HitRate,     TEXT("StackOBot/Hits per second"));
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_NetUpdateRate, TEXT("StackOBot/Net updates per second"));
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_StateUpdateRate, TEXT("StackOBot/State updates per second"));
+
+namespace
+{
+    constexpr int32 NumPhases   = static_cast<int32>(EDiskFieldPhase::Count);
+    constexpr int32 NumCounters = static_cast<int32>(EDiskFieldCounter::Count);
+
+    const TCHAR* PhaseNames[NumPhases] =
+    {
+        TEXT("SpawnerTick"), TEXT("SimulationTick"), TEXT("ApplyEvents"), TEXT("Significance"),
+        TEXT("PushTransforms"), TEXT("TopUpPool"), TEXT("UpdateHUD"), TEXT("Fire"), TEXT("FireTrace"),
+        TEXT("FireBeam"),
+    };
+
+    const TCHAR* CounterNames[NumCounters] =
+    {
+        TEXT("Respawns"), TEXT("Shots"), TEXT("Hits"), TEXT("NetUpdates"), TEXT("StateUpdates"),
+    };
+
+    /** Fixed ring of the most recent samples; no allocation after the first frame. */
+    struct FPhaseWindow
+    {
+        TArray<uint64, TFixedAllocator<FDiskFieldProfiler::WindowSize>> Samples;
+        int32 Next = 0;
+
+        void Add(uint64 Cycles)
+        {
+            if (Samples.Num() < FDiskFieldProfiler::WindowSize) Samples.Add(Cycles);
+            else                                                Samples[Next] = Cycles;
+            Next = (Next + 1) % FDiskFieldProfiler::WindowSize;
+        }
+    };
+
+    FPhaseWindow Phases[NumPhases];
+
+    int32  PendingCounts[NumCounters] = {};
+    float  Rates[NumCounters]         = {};
+    double RateWindowStart            = -1.0;
+
+    double CyclesToMs(uint64 Cycles)
+    {
+        return FPlatformTime::ToMilliseconds64(Cycles);
+    }
+
+    FAutoConsoleCommandWithOutputDevice PhaseTimesCommand(
+        TEXT("StackOBot.PhaseTimes"),
+        TEXT("Print rolling p50/p99/max of each disk-field and laser phase, plus respawn/shot/hit rates."),
+        FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FDiskFieldProfiler::Dump));
+}
+
+void FDiskFieldProfiler::AddSample(EDiskFieldPhase Phase, uint64 Cycles)
+{
+    Phases[static_cast<int32>(Phase)].Add(Cycles);
+}
+
+void FDiskFieldProfiler::AddCount(EDiskFieldCounter Counter, int32 Amount)
+{
+    PendingCounts[static_cast<int32>(Counter)] += Amount;
+}
+
+float FDiskFieldProfiler::GetRate(EDiskFieldCounter Counter)
+{
+    return Rates[static_cast<int32>(Counter)];
+}
+
+void FDiskFieldProfiler::Tick(double Now)
+{
+    if (RateWindowStart < 0.0) RateWindowStart = Now;
+
+    const double Elapsed = Now - RateWindowStart;
+    if (Elapsed < 1.0) return;
+
+    for (int32 i = 0; i < NumCounters; ++i)
+    {
+        Rates[i] = static_cast<float>(PendingCounts[i] / Elapsed);
+        PendingCounts[i] = 0;
+    }
+    RateWindowStart = Now;
+
+    SET_FLOAT_STAT(STAT_DiskField_RespawnRate, GetRate(EDiskFieldCounter::Respawns));
+    SET_FLOAT_STAT(STAT_DiskField_ShotRate,    GetRate(EDiskFieldCounter::Shots));
+    SET_FLOAT_STAT(STAT_DiskField_HitRate,     GetRate(EDiskFieldCounter::Hits));
+    SET_FLOAT_STAT(STAT_DiskField_NetUpdateRate, GetRate(EDiskFieldCounter::NetUpdates));
+    SET_FLOAT_STAT(STAT_DiskField_StateUpdateRate, GetRate(EDiskFieldCounter::StateUpdates));
+    TRACE_COUNTER_SET(DiskField_RespawnRate, GetRate(EDiskFieldCounter::Respawns));
+    TRACE_COUNTER_SET(DiskField_ShotRate,    GetRate(EDiskFieldCounter::Shots));
+    TRACE_COUNTER_SET(DiskField_HitRate,     GetRate(EDiskFieldCounter::Hits));
+    TRACE_COUNTER_SET(DiskField_NetUpdateRate, GetRate(EDiskFieldCounter::NetUpdates));
+    TRACE_COUNTER_SET(DiskField_StateUpdateRate, GetRate(EDiskFieldCounter::StateUpdates));
+}
+
+void FDiskFieldProfiler::Dump(FOutputDevice& Ar)
+{
+    Ar.Logf(TEXT("StackOBot phase times over the last %d samples (ms):"), WindowSize);
+    Ar.Logf(TEXT("  %-16s %7s %9s %9s %9s"), TEXT("Phase"), TEXT("Samples"), TEXT("p50"), TEXT("p99"), TEXT("max"));
+
+    TArray<uint64, TFixedAllocator<WindowSize>> Sorted;
+    for (int32 i = 0; i < NumPhases; ++i)
+    {
+        Sorted = Phases[i].Samples;
+        if (Sorted.Num() == 0) continue;
+        Sorted.Sort();
+
+        const int32 Last = Sorted.Num() - 1;
+        Ar.Logf(TEXT("  %-16s %7d %9.3f %9.3f %9.3f"), PhaseNames[i], Sorted.Num(),
+            CyclesToMs(Sorted[Last / 2]),
+            CyclesToMs(Sorted[FMath::FloorToInt32(Last * 0.99)]),
+            CyclesToMs(Sorted[Last]));
+    }
+
+    for (int32 i = 0; i < NumCounters; ++i)
+        Ar.Logf(TEXT("  %-16s %9.1f / s"), CounterNames[i], Rates[i]);
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StackOBot.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** Game-thread phases of the disk field and the laser, timed by DISKFIELD_PHASE_SCOPE. */
+enum class EDiskFieldPhase : uint8
+{
+    SpawnerTick,
+    SimulationTick,
+    ApplyEvents,
+    Significance,
+    PushTransforms,
+    TopUpPool,
+    UpdateHUD,
+    Fire,
+    FireTrace,
+    FireBeam,
+
+    Count
+};
+
+/** Event counts reported as per-second rates. */
+enum class EDiskFieldCounter : uint8
+{
+    Respawns,
+    Shots,
+    Hits,
+    NetUpdates,
+    StateUpdates,
+
+    Count
+};
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawner Tick"),    STAT_DiskField_SpawnerTick,    STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Tick"), STAT_DiskField_SimulationTick, STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Events"),    STAT_DiskField_ApplyEvents,    STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"),    STAT_DiskField_Significance,   STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Push Transforms"), STAT_DiskField_PushTransforms, STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Top Up Pool"),     STAT_DiskField_TopUpPool,      STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update HUD"),      STAT_DiskField_UpdateHUD,      STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire"),            STAT_DiskField_Fire,           STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire Trace"),      STAT_DiskField_FireTrace,      STATGROUP_StackOBot, STACKOBOT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire Beam"),       STAT_DiskField_FireBeam,       STATGROUP_StackOBot, STACKOBOT_API);
+
+/**
+ * Rolling timings for live sessions: the last WindowSize samples of every phase (about ten
+ * seconds at 60 FPS) and per-second event rates. `StackOBot.PhaseTimes` prints p50/p99/max.
+ * Game thread only; the recording macros compile out of Shipping builds.
+ */
+struct STACKOBOT_API FDiskFieldProfiler
+{
+    static constexpr int32 WindowSize = 600;
+
+    static void AddSample(EDiskFieldPhase Phase, uint64 Cycles);
+    static void AddCount(EDiskFieldCounter Counter, int32 Amount = 1);
+
+    /** Events per second over the last completed second. */
+    static float GetRate(EDiskFieldCounter Counter);
+
+    /** Call once per frame; closes the per-second rate window and publishes the rate stats. */
+    static void Tick(double Now);
+
+    static void Dump(FOutputDevice& Ar);
+};
+
+#define DISKFIELD_PHASE_TIMING !UE_BUILD_SHIPPING
+
+#if DISKFIELD_PHASE_TIMING
+struct FDiskFieldPhaseScope
+{
+    explicit FDiskFieldPhaseScope(EDiskFieldPhase InPhase)
+        : Phase(InPhase), StartCycles(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FDiskFieldPhaseScope()
+    {
+        FDiskFieldProfiler::AddSample(Phase, FPlatformTime::Cycles64() - StartCycles);
+    }
+
+private:
+    EDiskFieldPhase Phase;
+    uint64          StartCycles;
+};
+
+#define DISKFIELD_PHASE_RECORD(Phase) FDiskFieldPhaseScope PREPROCESSOR_JOIN(DiskFieldPhaseScope_, __LINE__)(EDiskFieldPhase::Phase)
+#define DISKFIELD_COUNT(Counter, Amount) FDiskFieldProfiler::AddCount(EDiskFieldCounter::Counter, Amount)
+#else
+#define DISKFIELD_PHASE_RECORD(Phase)
+#define DISKFIELD_COUNT(Counter, Amount)
+#endif
+
+/** Stat cycle counter, Insights scope on the StackOBot channel and rolling sample for one phase. */
+#define DISKFIELD_PHASE_SCOPE(Phase) \
+    SCOPE_CYCLE_COUNTER(STAT_DiskField_##Phase); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DiskField_##Phase, StackOBotChannel); \
+    DISKFIELD_PHASE_RECORD(Phase)
\ No newline at end of file
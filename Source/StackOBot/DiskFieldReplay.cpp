@@ -0,0 +1,393 @@
+#include "DiskFieldReplay.h"
+
+#include "Algo/Compare.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace
+{
+    enum EReplayOp : uint8
+    {
+        OpTick    = 0,
+        OpHit     = 1,
+        OpRelease = 2,
+        OpEvents  = 3,
+        OpMiss    = 4,
+        OpMask    = 0x07,
+
+        FlagDeltaTime = 0x08,   // Tick: frame time differs from the previous tick
+        FlagPlayers   = 0x10,   // Tick: player slots changed; heights follow in full
+        FlagRepeat    = 0x20,   // Tick: a run of ticks that all matched the prediction exactly
+    };
+
+    constexpr int32 MaxPackedBytes = 5;
+    constexpr int32 MaxFlushBytes  = 1 + MaxPackedBytes;
+
+    uint32 ZigZag(int32 Value)   { return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31); }
+    int32  UnZigZag(uint32 Value) { return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1); }
+
+    void WritePacked(FArchive& Ar, uint32 Value) { Ar.SerializeIntPacked(Value); }
+    void WriteSigned(FArchive& Ar, int32 Value)  { WritePacked(Ar, ZigZag(Value)); }
+
+    uint32 ReadPacked(FArchive& Ar) { uint32 Value = 0; Ar.SerializeIntPacked(Value); return Value; }
+    int32  ReadSigned(FArchive& Ar) { return UnZigZag(ReadPacked(Ar)); }
+}
+
+// ── Recorder ─────────────────────────────────────────────────────────────────
+
+void FDiskReplayRecorder::Start(FDiskSimulation& Sim, int32 CapacityBytes, bool bInRecordEvents)
+{
+    Buffer.Reset();
+    Buffer.Reserve(CapacityBytes);
+    Capacity        = CapacityBytes;
+    bRecording      = true;
+    bFull           = false;
+    bRecordEvents   = bInRecordEvents;
+    RecordedSeconds = 0.0;
+
+    LastDeltaSteps = 0;
+    PendingRepeats = 0;
+    LastSlots.Reset();
+    LastZ.Reset();
+    LastDZ.Reset();
+
+    FMemoryWriter Ar(Buffer);
+    uint32 Magic   = FDiskReplay::Magic;
+    uint16 Version = FDiskReplay::Version;
+    uint8  Flags   = bRecordEvents ? FDiskReplay::HeaderHasEvents : 0;
+    Ar << Magic << Version << Flags;
+    Sim.SerializeState(Ar);
+
+    if (Buffer.Num() > Capacity)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FDiskReplayRecorder: the %d-byte snapshot does not fit in %d bytes"),
+            Buffer.Num(), Capacity);
+        bFull = true;
+    }
+}
+
+bool FDiskReplayRecorder::Stop(const FString& Path)
+{
+    if (!bRecording) return false;
+    if (!bFull) FlushRepeats();
+    bRecording = false;
+
+    const bool   bSaved      = FFileHelper::SaveArrayToFile(Buffer, *Path);
+    const double KBPerMinute = RecordedSeconds > 0.0 ? Buffer.Num() / 1024.0 / (RecordedSeconds / 60.0) : 0.0;
+    UE_LOG(LogTemp, Log, TEXT("FDiskReplayRecorder: %s %d bytes (%.1f s, %.1f KB/min%s) to %s"),
+        bSaved ? TEXT("wrote") : TEXT("failed to write"), Buffer.Num(), RecordedSeconds, KBPerMinute,
+        bRecordEvents ? TEXT(", with events") : TEXT(""), *Path);
+
+    Buffer.Empty();
+    return bSaved;
+}
+
+bool FDiskReplayRecorder::HasRoom(int32 Bytes)
+{
+    if (!bRecording || bFull) return false;
+    if (Buffer.Num() + Bytes + MaxFlushBytes <= Capacity) return true;
+
+    UE_LOG(LogTemp, Warning, TEXT("FDiskReplayRecorder: buffer full at %d bytes; the rest of the session is not recorded"),
+        Buffer.Num());
+    FlushRepeats();   // HasRoom always leaves space for this
+    bFull = true;
+    return false;
+}
+
+void FDiskReplayRecorder::FlushRepeats()
+{
+    if (PendingRepeats == 0) return;
+
+    FMemoryWriter Ar(Buffer, /*bIsPersistent=*/false, /*bSetOffset=*/true);
+    uint8 Tag = OpTick | FlagRepeat;
+    Ar << Tag;
+    WritePacked(Ar, PendingRepeats);
+    PendingRepeats = 0;
+}
+
+void FDiskReplayRecorder::RecordTick(float DeltaTime, TConstArrayView<FDiskPlayer> Players)
+{
+    if (!HasRoom(1 + MaxPackedBytes * (2 + 2 * Players.Num()))) return;
+    RecordedSeconds += DeltaTime;
+
+    bool bPlayersChanged = Players.Num() != LastSlots.Num();
+    for (int32 i = 0; i < Players.Num() && !bPlayersChanged; ++i)
+        bPlayersChanged = Players[i].Slot != LastSlots[i];
+
+    const int32 DeltaSteps = FDiskReplay::DeltaTimeToSteps(DeltaTime);
+
+    uint8 Tag = OpTick;
+    if (DeltaSteps != LastDeltaSteps) Tag |= FlagDeltaTime;
+    if (bPlayersChanged)              Tag |= FlagPlayers;
+
+    // A tick the delta coding predicts exactly only bumps the current run.
+    bool bPredicted = Tag == OpTick;
+    for (int32 i = 0; i < Players.Num() && bPredicted; ++i)
+        bPredicted = FDiskReplay::HeightToSteps(Players[i].Z) == LastZ[i] + LastDZ[i];
+    if (bPredicted)
+    {
+        for (int32 i = 0; i < Players.Num(); ++i)
+            LastZ[i] += LastDZ[i];
+        ++PendingRepeats;
+        return;
+    }
+
+    FlushRepeats();
+    FMemoryWriter Ar(Buffer, /*bIsPersistent=*/false, /*bSetOffset=*/true);
+    Ar << Tag;
+
+    if (Tag & FlagDeltaTime)
+        WriteSigned(Ar, DeltaSteps - LastDeltaSteps);
+    LastDeltaSteps = DeltaSteps;
+
+    if (bPlayersChanged)
+    {
+        LastSlots.Reset();
+        LastZ.Reset();
+        LastDZ.Reset();
+
+        WritePacked(Ar, Players.Num());
+        for (const FDiskPlayer& Player : Players)
+        {
+            const int32 Z = FDiskReplay::HeightToSteps(Player.Z);
+            WritePacked(Ar, Player.Slot);
+            WriteSigned(Ar, Z);
+            LastSlots.Add(Player.Slot);
+            LastZ.Add(Z);
+            LastDZ.Add(0);
+        }
+        return;
+    }
+
+    // Residual against the player continuing at last frame's vertical speed.
+    for (int32 i = 0; i < Players.Num(); ++i)
+    {
+        const int32 Z = FDiskReplay::HeightToSteps(Players[i].Z);
+        WriteSigned(Ar, Z - (LastZ[i] + LastDZ[i]));
+        LastDZ[i] = Z - LastZ[i];
+        LastZ[i]  = Z;
+    }
+}
+
+void FDiskReplayRecorder::RecordHit(int32 Index, float PlayerZ, int32 Slot)
+{
+    if (!HasRoom(1 + MaxPackedBytes * 3)) return;
+
+    FlushRepeats();
+    FMemoryWriter Ar(Buffer, false, true);
+    uint8 Tag = OpHit;
+    Ar << Tag;
+    WritePacked(Ar, Index);
+    WritePacked(Ar, Slot);
+    WriteSigned(Ar, FDiskReplay::HeightToSteps(PlayerZ));
+}
+
+void FDiskReplayRecorder::RecordMiss()
+{
+    if (!HasRoom(1)) return;
+
+    FlushRepeats();
+    FMemoryWriter Ar(Buffer, false, true);
+    uint8 Tag = OpMiss;
+    Ar << Tag;
+}
+
+void FDiskReplayRecorder::RecordRelease(int32 Slot)
+{
+    if (!HasRoom(1 + MaxPackedBytes)) return;
+
+    FlushRepeats();
+    FMemoryWriter Ar(Buffer, false, true);
+    uint8 Tag = OpRelease;
+    Ar << Tag;
+    WritePacked(Ar, Slot);
+}
+
+void FDiskReplayRecorder::RecordEvents(TConstArrayView<FDiskEvent> Events)
+{
+    if (!bRecordEvents || Events.Num() == 0 || !HasRoom(1 + MaxPackedBytes * (1 + Events.Num()))) return;
+
+    FlushRepeats();
+    FMemoryWriter Ar(Buffer, false, true);
+    uint8 Tag = OpEvents;
+    Ar << Tag;
+    WritePacked(Ar, Events.Num());
+    for (const FDiskEvent& Event : Events)
+        WritePacked(Ar, (static_cast<uint32>(Event.Index) << 3) | static_cast<uint32>(Event.Type));
+}
+
+// ── Player ───────────────────────────────────────────────────────────────────
+
+FDiskReplayPlayer::FDiskReplayPlayer() = default;
+FDiskReplayPlayer::~FDiskReplayPlayer() = default;
+
+bool FDiskReplayPlayer::Open(const FString& Path)
+{
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    LoadedData.Empty();
+    Data = {};
+
+    FOpenMappedResult Mapped = FPlatformFileManager::Get().GetPlatformFile().OpenMappedEx(*Path);
+    if (Mapped.HasValue())
+    {
+        MappedFile = Mapped.StealValue();
+        MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+    }
+
+    if (MappedRegion)
+    {
+        Data = MakeArrayView(MappedRegion->GetMappedPtr(), static_cast<int32>(MappedRegion->GetMappedSize()));
+        return true;
+    }
+
+    if (!FFileHelper::LoadFileToArray(LoadedData, *Path)) return false;
+    Data = LoadedData;
+    return true;
+}
+
+bool FDiskReplayPlayer::Play(FDiskSimulation& Sim, FDiskReplayStats& OutStats) const
+{
+    FMemoryReaderView Ar(Data);
+
+    uint32 Magic   = 0;
+    uint16 Version = 0;
+    uint8  Flags   = 0;
+    Ar << Magic << Version;
+    if (Magic != FDiskReplay::Magic || Version != FDiskReplay::Version)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FDiskReplayPlayer: not a version %d disk-field replay"), FDiskReplay::Version);
+        return false;
+    }
+    Ar << Flags;
+
+    Sim.SerializeState(Ar);
+    if (Ar.IsError()) return false;
+    Sim.Events.Reset();
+
+    // Without recorded events there is nothing to check them against: count and drop them
+    // as they are made, so Events never grows past one tick's worth.
+    OutStats.bEventsChecked = (Flags & FDiskReplay::HeaderHasEvents) != 0;
+    auto DropEvents = [&Sim, &OutStats]()
+    {
+        if (OutStats.bEventsChecked) return;
+        OutStats.Events += Sim.Events.Num();
+        Sim.Events.Reset();
+    };
+
+    int32               DeltaSteps = 0;
+    TArray<FDiskPlayer> Players;
+    TArray<int32>       LastZ;
+    TArray<int32>       LastDZ;
+    TArray<FDiskEvent>  Recorded;
+
+    while (!Ar.AtEnd() && !Ar.IsError())
+    {
+        uint8 Tag = 0;
+        Ar << Tag;
+
+        switch (Tag & OpMask)
+        {
+        case OpTick:
+        {
+            if (Tag & FlagRepeat)
+            {
+                const int32 NumTicks  = static_cast<int32>(ReadPacked(Ar));
+                const float DeltaTime = FDiskReplay::StepsToDeltaTime(DeltaSteps);
+                for (int32 Repeat = 0; Repeat < NumTicks; ++Repeat)
+                {
+                    for (int32 i = 0; i < Players.Num(); ++i)
+                    {
+                        LastZ[i] += LastDZ[i];
+                        Players[i].Z = FDiskReplay::StepsToHeight(LastZ[i]);
+                    }
+                    Sim.Tick(DeltaTime, Players);
+                    OutStats.SimSeconds += DeltaTime;
+                    DropEvents();
+                }
+                OutStats.Ticks += NumTicks;
+                break;
+            }
+
+            if (Tag & FlagDeltaTime)
+                DeltaSteps += ReadSigned(Ar);
+
+            if (Tag & FlagPlayers)
+            {
+                const int32 NumPlayers = static_cast<int32>(ReadPacked(Ar));
+                Players.Reset();
+                LastZ.Reset();
+                LastDZ.Reset();
+                for (int32 i = 0; i < NumPlayers && !Ar.IsError(); ++i)
+                {
+                    const int32 Slot = static_cast<int32>(ReadPacked(Ar));
+                    const int32 Z    = ReadSigned(Ar);
+                    Players.Add({ Slot, FDiskReplay::StepsToHeight(Z) });
+                    LastZ.Add(Z);
+                    LastDZ.Add(0);
+                }
+            }
+            else
+            {
+                for (int32 i = 0; i < Players.Num(); ++i)
+                {
+                    const int32 Z = LastZ[i] + LastDZ[i] + ReadSigned(Ar);
+                    Players[i].Z = FDiskReplay::StepsToHeight(Z);
+                    LastDZ[i] = Z - LastZ[i];
+                    LastZ[i]  = Z;
+                }
+            }
+
+            const float DeltaTime = FDiskReplay::StepsToDeltaTime(DeltaSteps);
+            Sim.Tick(DeltaTime, Players);
+            ++OutStats.Ticks;
+            OutStats.SimSeconds += DeltaTime;
+            DropEvents();
+            break;
+        }
+        case OpHit:
+        {
+            const int32 Index = static_cast<int32>(ReadPacked(Ar));
+            const int32 Slot  = static_cast<int32>(ReadPacked(Ar));
+            const float Z     = FDiskReplay::StepsToHeight(ReadSigned(Ar));
+            Sim.HitDisk(Index, Z, Slot);
+            ++OutStats.Hits;
+            DropEvents();
+            break;
+        }
+        case OpMiss:
+            Sim.MissShot();
+            ++OutStats.Misses;
+            DropEvents();
+            break;
+
+        case OpRelease:
+            Sim.ReleasePlayer(static_cast<int32>(ReadPacked(Ar)));
+            DropEvents();
+            break;
+
+        case OpEvents:
+        {
+            const int32 NumEvents = static_cast<int32>(ReadPacked(Ar));
+            Recorded.Reset();
+            for (int32 i = 0; i < NumEvents && !Ar.IsError(); ++i)
+            {
+                const uint32 Packed = ReadPacked(Ar);
+                Recorded.Add({ static_cast<int32>(Packed >> 3), static_cast<EDiskEvent>(Packed & 7) });
+            }
+
+            const bool bSame = Algo::Compare(Recorded, Sim.Events,
+                [](const FDiskEvent& A, const FDiskEvent& B) { return A.Index == B.Index && A.Type == B.Type; });
+            OutStats.Mismatches += !bSame;
+            OutStats.Events     += NumEvents;
+            Sim.Events.Reset();
+            break;
+        }
+        }
+    }
+
+    return !Ar.IsError();
+}
\ No newline at end of file
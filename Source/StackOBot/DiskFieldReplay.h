@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiskSimulation.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Replay format shared by FDiskReplayRecorder and FDiskReplayPlayer.
+ *
+ * A recording is a snapshot of FDiskSimulation (FDiskSimulation::SerializeState, which carries
+ * the seed) followed by the inputs applied to it since, as a stream of tagged ops: Tick (frame
+ * time and player heights), Hit, Miss (a shot that hit no disk), Release (a player left) and,
+ * optionally, Events (what the rules did, kept so a replay can check that it still reproduces
+ * the session). Events are the bulk of a large field's recording and can always be regenerated
+ * by re-simulating, so they are only written when asked for; a header flag says which.
+ *
+ * Ticks are delta coded: the frame time against the previous frame, and each player's height
+ * against a straight-line prediction from its last two samples. A run of ticks that match the
+ * prediction exactly (steady frame time, players standing or climbing evenly) is stored as one
+ * count. The live game feeds the simulation the same quantized values it records, so a replay
+ * of the same build is exact. Heights are relative to the simulation's HeightBase, which the
+ * replay moves at the same ticks the session did.
+ */
+struct STACKOBOT_API FDiskReplay
+{
+    static constexpr uint32 Magic   = 0x50524644;   // "DFRP"
+    static constexpr uint16 Version = 5;
+
+    /** Header flags, after the version. */
+    static constexpr uint8 HeaderHasEvents = 0x01;
+
+    /** Frame times are recorded in 0.1 ms steps and heights in 1/8 UU steps. */
+    static constexpr float DeltaTimeStep = 1e-4f;
+    static constexpr float HeightStep    = 1.f / 8.f;
+
+    static int32 DeltaTimeToSteps(float DeltaTime) { return FMath::RoundToInt32(DeltaTime / DeltaTimeStep); }
+    static float StepsToDeltaTime(int32 Steps)     { return Steps * DeltaTimeStep; }
+    static int32 HeightToSteps(float Z)            { return FMath::RoundToInt32(Z / HeightStep); }
+    static float StepsToHeight(int32 Steps)        { return Steps * HeightStep; }
+
+    /** The values the simulation is actually fed, recorded or not. */
+    static float QuantizeDeltaTime(float DeltaTime) { return StepsToDeltaTime(DeltaTimeToSteps(DeltaTime)); }
+    static float QuantizeHeight(float Z)            { return StepsToHeight(HeightToSteps(Z)); }
+};
+
+/**
+ * Records one disk-field session into a buffer allocated once at Start, so recording never
+ * allocates mid-game. When the buffer is full, later inputs are dropped with a warning; the
+ * file still replays up to that point.
+ */
+class STACKOBOT_API FDiskReplayRecorder
+{
+public:
+    /**
+     * Begin a recording from Sim's current state, reserving CapacityBytes up front. With
+     * bInRecordEvents, RecordEvents writes the rules' output too, for DiskFieldReplay to check.
+     */
+    void Start(FDiskSimulation& Sim, int32 CapacityBytes, bool bInRecordEvents = false);
+
+    /** Write the recording to Path and stop; logs its size per minute. Returns false if not recording or the write failed. */
+    bool Stop(const FString& Path);
+
+    bool  IsRecording() const { return bRecording; }
+    int32 GetNumBytes() const { return Buffer.Num(); }
+
+    /** Call with exactly what was passed to FDiskSimulation::Tick / HitDisk / MissShot / ReleasePlayer. */
+    void RecordTick(float DeltaTime, TConstArrayView<FDiskPlayer> Players);
+    void RecordHit(int32 Index, float PlayerZ, int32 Slot);
+    void RecordMiss();
+    void RecordRelease(int32 Slot);
+
+    /** Call with FDiskSimulation::Events each time the owner drains them. Ignored unless Start asked for events. */
+    void RecordEvents(TConstArrayView<FDiskEvent> Events);
+
+private:
+    TArray<uint8> Buffer;
+    int32  Capacity        = 0;
+    bool   bRecording      = false;
+    bool   bFull           = false;
+    bool   bRecordEvents   = false;
+    double RecordedSeconds = 0.0;   // Simulation time covered so far
+
+    // Delta-coding state, mirrored by FDiskReplayPlayer
+    int32         LastDeltaSteps = 0;
+    int32         PendingRepeats = 0;   // Predicted ticks not yet written
+    TArray<int32> LastSlots;
+    TArray<int32> LastZ;
+    TArray<int32> LastDZ;
+
+    /** False (and the recording frozen) if Bytes more would not fit. */
+    bool HasRoom(int32 Bytes);
+
+    /** Write the pending run of predicted ticks, if any, ahead of the next op. */
+    void FlushRepeats();
+};
+
+/** Totals of one replay run. */
+struct FDiskReplayStats
+{
+    int32  Ticks          = 0;
+    int32  Hits           = 0;
+    int32  Misses         = 0;
+    int32  Events         = 0;       // Recorded events, or the ones re-simulated if none were recorded
+    int32  Mismatches     = 0;       // Event batches that differed from the recording
+    bool   bEventsChecked = false;   // The recording had events to compare against
+    double SimSeconds     = 0.0;
+};
+
+/**
+ * Re-runs a recording against a headless FDiskSimulation as fast as it will go. The file is
+ * memory mapped where the platform allows it and read in place.
+ */
+class STACKOBOT_API FDiskReplayPlayer
+{
+public:
+    FDiskReplayPlayer();
+    ~FDiskReplayPlayer();
+
+    bool Open(const FString& Path);
+
+    int32 GetNumBytes() const { return Data.Num(); }
+
+    /** Load the recorded starting state into Sim and apply every recorded input. */
+    bool Play(FDiskSimulation& Sim, FDiskReplayStats& OutStats) const;
+
+private:
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;   // Declared after MappedFile so it unmaps first
+    TArray<uint8>                 LoadedData;     // Used when the file cannot be mapped
+    TArrayView<const uint8>       Data;
+};
\ No newline at end of file
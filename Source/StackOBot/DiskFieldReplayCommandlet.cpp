@@ -0,0 +1,78 @@
+#include "DiskFieldReplayCommandlet.h"
+#include "DiskFieldReplay.h"
+#include "DiskSimulation.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UDiskFieldReplayCommandlet::UDiskFieldReplayCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+    HelpDescription = TEXT("Replays a recorded disk-field session headlessly and reports how fast it re-simulates.");
+    HelpUsage = TEXT("-run=DiskFieldReplay -nullrhi -File=<Saved/Replays/...> [-Repeat=1]");
+}
+
+int32 UDiskFieldReplayCommandlet::Main(const FString& Params)
+{
+    FString File;
+    int32   Repeat = 1;
+    FParse::Value(*Params, TEXT("File="), File);
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(1, Repeat);
+
+    FDiskReplayPlayer Player;
+    if (File.IsEmpty() || !Player.Open(File))
+    {
+        UE_LOG(LogTemp, Error, TEXT("DiskFieldReplay: cannot open replay '%s'"), *File);
+        return 1;
+    }
+
+    const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("DiskFieldReplay.csv");
+    FString Csv;
+    if (!FPaths::FileExists(CsvPath))
+        Csv = TEXT("File,Bytes,Disks,Ticks,Hits,Events,SimSeconds,WallSeconds,Speedup,Mismatches\n");
+
+    int32 TotalMismatches = 0;
+    for (int32 Run = 0; Run < Repeat; ++Run)
+    {
+        FDiskSimulation  Sim;
+        FDiskReplayStats Stats;
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        const bool   bOk = Player.Play(Sim, Stats);
+        const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        if (!bOk)
+        {
+            UE_LOG(LogTemp, Error, TEXT("DiskFieldReplay: '%s' is not a readable replay"), *File);
+            return 1;
+        }
+
+        const double Speedup = Seconds > 0.0 ? Stats.SimSeconds / Seconds : 0.0;
+        TotalMismatches += Stats.Mismatches;
+
+        UE_LOG(LogTemp, Display, TEXT("DiskFieldReplay: run %d  %d disks  %d ticks (%.1f s)  %d hits  %d misses  %d events  %.3f s wall  %.0fx real time  %d mismatched batches"),
+            Run, Sim.Num(), Stats.Ticks, Stats.SimSeconds, Stats.Hits, Stats.Misses, Stats.Events, Seconds, Speedup, Stats.Mismatches);
+        if (!Stats.bEventsChecked)
+            UE_LOG(LogTemp, Display, TEXT("DiskFieldReplay: recorded without events; re-simulated but not checked against the session"));
+        if (Sim.Difficulty.Config.bEnabled)
+        {
+            UE_LOG(LogTemp, Display, TEXT("DiskFieldReplay: difficulty scale %.3f  climb %.1f UU/s  accuracy %.0f%%  %.1f falls/min"),
+                Sim.Difficulty.GetTargetScale(), Sim.Difficulty.GetClimbRate(), Sim.Difficulty.GetAccuracy() * 100.f,
+                Sim.Difficulty.GetFallsPerMinute());
+        }
+        Csv += FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%.3f,%.6f,%.1f,%d\n"), *FPaths::GetCleanFilename(File),
+            Player.GetNumBytes(), Sim.Num(), Stats.Ticks, Stats.Hits, Stats.Events, Stats.SimSeconds, Seconds, Speedup, Stats.Mismatches);
+    }
+
+    FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+        &IFileManager::Get(), FILEWRITE_Append);
+    UE_LOG(LogTemp, Display, TEXT("DiskFieldReplay: appended to %s"), *CsvPath);
+
+    return TotalMismatches == 0 ? 0 : 2;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DiskFieldReplayCommandlet.generated.h"
+
+/**
+ * Re-simulates a recorded disk-field session headlessly, as fast as the simulation runs, and
+ * checks every event batch against the recording:
+ *
+ *   UnrealEditor-Cmd StackOBot.uproject -run=DiskFieldReplay -nullrhi -File=<path> [-Repeat=10]
+ *
+ * Recordings come from ADiskSpawner (bRecordReplay or StackOBot.Replay.Start) and live in
+ * Saved/Replays/. Each run is timed; the results are logged and appended to
+ * Saved/Profiling/DiskFieldReplay.csv, so the same workload can be compared across builds.
+ * Returns non-zero if the replay diverged from the recording.
+ *
+ * Sessions recorded with bAutoDifficulty re-run the difficulty controller on the same inputs,
+ * so its tuning is checked with the events and its final readings are logged.
+ */
+UCLASS()
+class STACKOBOT_API UDiskFieldReplayCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UDiskFieldReplayCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
\ No newline at end of file
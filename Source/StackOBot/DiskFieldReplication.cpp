@@ -0,0 +1,39 @@
+#include "DiskFieldReplication.h"
+#include "DiskSpawner.h"
+
+bool FDiskNetItem::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 PackedCell = static_cast<uint32>(Cell);
+    Ar.SerializeIntPacked(PackedCell);
+
+    // Zig-zag so small negative heights stay short too.
+    uint32 PackedZ = (static_cast<uint32>(BaseZ) << 1) ^ static_cast<uint32>(BaseZ >> 31);
+    Ar.SerializeIntPacked(PackedZ);
+
+    uint8 StateByte = static_cast<uint8>(State);
+    Ar << SpeedQ;
+    Ar << StateByte;
+    Ar << AnchorTime;
+
+    if (Ar.IsLoading())
+    {
+        Cell  = static_cast<int32>(PackedCell);
+        BaseZ = static_cast<int32>(PackedZ >> 1) ^ -static_cast<int32>(PackedZ & 1);
+        State = static_cast<EDiskState>(FMath::Min<uint8>(StateByte, static_cast<uint8>(EDiskState::FrozenGreen)));
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+
+void FDiskNetItem::PostReplicatedAdd(const FDiskNetArray& InArraySerializer)
+{
+    if (ADiskSpawner* Spawner = InArraySerializer.Spawner.Get())
+        Spawner->ApplyNetDisk(*this);
+}
+
+void FDiskNetItem::PostReplicatedChange(const FDiskNetArray& InArraySerializer)
+{
+    if (ADiskSpawner* Spawner = InArraySerializer.Spawner.Get())
+        Spawner->ApplyNetDisk(*this);
+}
\ No newline at end of file
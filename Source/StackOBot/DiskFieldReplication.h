@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "DiskFieldTypes.h"
+#include "DiskFieldReplication.generated.h"
+
+class ADiskSpawner;
+
+/**
+ * Replicated state of one disk, sent only when it changes state or respawns. Between changes
+ * a falling disk's height is BaseZ - Speed * (ServerTime - AnchorTime), so clients extrapolate
+ * it locally and steady falling costs no bandwidth.
+ */
+USTRUCT()
+struct FDiskNetItem : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    /** Speeds travel in 1/16 UU/s steps, so 16 bits cover 0..4095 UU/s. */
+    static constexpr float SpeedQuantum = 1.f / 16.f;
+
+    UPROPERTY()
+    int32 Cell = INDEX_NONE;
+
+    UPROPERTY()
+    int32 BaseZ = 0;            // Height at AnchorTime, whole UU
+
+    UPROPERTY()
+    uint16 SpeedQ = 0;          // Fall speed in SpeedQuantum steps; 0 while frozen
+
+    UPROPERTY()
+    EDiskState State = EDiskState::Falling;
+
+    UPROPERTY()
+    float AnchorTime = 0.f;     // Server world time at which the disk was at BaseZ
+
+    float GetSpeed() const { return SpeedQ * SpeedQuantum; }
+    double GetZ(float ServerTime) const { return BaseZ - static_cast<double>(GetSpeed() * (ServerTime - AnchorTime)); }
+
+    /** Packed: cell and height as variable-length ints, state in one byte. */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+    void PostReplicatedAdd(const struct FDiskNetArray& InArraySerializer);
+    void PostReplicatedChange(const struct FDiskNetArray& InArraySerializer);
+};
+
+template<>
+struct TStructOpsTypeTraits<FDiskNetItem> : public TStructOpsTypeTraitsBase2<FDiskNetItem>
+{
+    enum { WithNetSerializer = true };
+};
+
+/** Delta-replicated disk field: one item per grid cell, in cell order on the server. */
+USTRUCT()
+struct FDiskNetArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FDiskNetItem> Items;
+
+    /** Receives the items on clients; set by the owning spawner. */
+    TWeakObjectPtr<ADiskSpawner> Spawner;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FDiskNetItem, FDiskNetArray>(Items, DeltaParms, *this);
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FDiskNetArray> : public TStructOpsTypeTraitsBase2<FDiskNetArray>
+{
+    enum { WithNetDeltaSerializer = true };
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "DiskFieldSubsystem.h"
+#include "DiskSpawner.h"
+
+#include "Engine/World.h"
+
+void UDiskFieldSubsystem::RegisterSpawner(ADiskSpawner* InSpawner)
+{
+    if (Spawner.IsValid() && Spawner.Get() != InSpawner)
+    {
+        UE_LOG(LogTemp, Warning,
+            TEXT("DiskFieldSubsystem: %s replaces %s; only one ADiskSpawner per level is supported."),
+            *GetNameSafe(InSpawner), *GetNameSafe(Spawner.Get()));
+    }
+    Spawner = InSpawner;
+}
+
+void UDiskFieldSubsystem::UnregisterSpawner(ADiskSpawner* InSpawner)
+{
+    if (Spawner.Get() == InSpawner)
+        Spawner.Reset();
+}
+
+ADiskSpawner* UDiskFieldSubsystem::FindSpawner(const UObject* WorldContext)
+{
+    const UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
+    const UDiskFieldSubsystem* Subsystem = World ? World->GetSubsystem<UDiskFieldSubsystem>() : nullptr;
+    return Subsystem ? Subsystem->GetSpawner() : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DiskSimulation.h"
+#include "DiskFieldSubsystem.generated.h"
+
+class ADiskSpawner;
+
+/** Disk state changes applied this batch, in the order the rules made them. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDiskStateChanged, TConstArrayView<FDiskEvent> /*Events*/);
+
+/**
+ * Per-world registry for the disk field. ADiskSpawner registers itself before any BeginPlay
+ * runs, so shooters, the HUD and other systems resolve it in O(1) instead of scanning actors,
+ * and can subscribe to its state changes without a reference to the spawner.
+ */
+UCLASS()
+class STACKOBOT_API UDiskFieldSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    void RegisterSpawner(ADiskSpawner* InSpawner);
+    void UnregisterSpawner(ADiskSpawner* InSpawner);
+
+    ADiskSpawner* GetSpawner() const { return Spawner.Get(); }
+
+    /** The spawner of WorldContext's world, or null if there is none (yet). */
+    static ADiskSpawner* FindSpawner(const UObject* WorldContext);
+
+    /** Broadcast by the registered spawner each time it applies a batch of disk events. */
+    FOnDiskStateChanged OnDiskStateChanged;
+
+private:
+    TWeakObjectPtr<ADiskSpawner> Spawner;
+};
\ No newline at end of file
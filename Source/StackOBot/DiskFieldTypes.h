@@ -0,0 +1,14 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiskFieldTypes.generated.h"
+
+// ─── Disk state ────────────────────────────────────────────────────────────────
+// Lives apart from AFallingDisk so the headless FDiskSimulation core needs no actor headers.
+UENUM(BlueprintType)
+enum class EDiskState : uint8
+{
+    Falling      UMETA(DisplayName = "Falling"),
+    FrozenRed    UMETA(DisplayName = "Frozen Red  (one above player)"),
+    FrozenGreen  UMETA(DisplayName = "Frozen Green (below player)"),
+};
@@ -0,0 +1,36 @@
+#include "DiskGrid.h"
+
+void FDiskGrid::Init(const FVector2D& Center, int32 InColumns, int32 InRows, float InCellSize)
+{
+    Columns  = InColumns;
+    Rows     = InRows;
+    CellSize = InCellSize;
+    Min      = Center - FVector2D(Columns * CellSize, Rows * CellSize) * 0.5f;
+}
+
+int32 FDiskGrid::CellAt(const FVector2D& P) const
+{
+    const int32 Col = FMath::FloorToInt32((P.X - Min.X) / CellSize);
+    const int32 Row = FMath::FloorToInt32((P.Y - Min.Y) / CellSize);
+    if (Col < 0 || Col >= Columns || Row < 0 || Row >= Rows) return INDEX_NONE;
+    return Col + Row * Columns;
+}
+
+void FDiskGrid::CellsInRadius(const FVector2D& Center, float Radius, TArray<int32>& OutCells) const
+{
+    // Only the cells under the circle's bounding square are visited.
+    const int32 ColLo = FMath::Max(0, FMath::FloorToInt32((Center.X - Radius - Min.X) / CellSize));
+    const int32 ColHi = FMath::Min(Columns - 1, FMath::FloorToInt32((Center.X + Radius - Min.X) / CellSize));
+    const int32 RowLo = FMath::Max(0, FMath::FloorToInt32((Center.Y - Radius - Min.Y) / CellSize));
+    const int32 RowHi = FMath::Min(Rows - 1, FMath::FloorToInt32((Center.Y + Radius - Min.Y) / CellSize));
+
+    const double RadiusSq = FMath::Square(Radius);
+    for (int32 Row = RowLo; Row <= RowHi; ++Row)
+    {
+        for (int32 Col = ColLo; Col <= ColHi; ++Col)
+        {
+            if (FVector2D::DistSquared(CellCenter(Col, Row), Center) <= RadiusSq)
+                OutCells.Add(Col + Row * Columns);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * XY layout of the disk grid: Columns x Rows cells of CellSize, centred on the spawner.
+ * Cell index = Col + Row * Columns, matching ADiskSpawner's Disks and FDiskSimulation.
+ */
+struct FDiskGrid
+{
+    FVector2D Min = FVector2D::ZeroVector;   // World XY of the grid's lower corner
+    float     CellSize = 350.f;
+    int32     Columns = 0;
+    int32     Rows = 0;
+
+    void Init(const FVector2D& Center, int32 InColumns, int32 InRows, float InCellSize);
+
+    int32 Num() const { return Columns * Rows; }
+
+    FVector2D CellCenter(int32 Col, int32 Row) const
+    {
+        return Min + FVector2D((Col + 0.5f) * CellSize, (Row + 0.5f) * CellSize);
+    }
+
+    /** Cell containing world point P, or INDEX_NONE outside the grid. */
+    int32 CellAt(const FVector2D& P) const;
+
+    /** Append every cell whose centre lies within Radius of Center (XY only). */
+    void CellsInRadius(const FVector2D& Center, float Radius, TArray<int32>& OutCells) const;
+
+    /**
+     * DDA walk over the cells the XY projection of Start->End crosses, nearest first.
+     * Visit(CellIndex) returns false to stop early. Cost is proportional to the cells crossed.
+     */
+    template <typename FuncType>
+    void WalkSegment(const FVector2D& Start, const FVector2D& End, FuncType&& Visit) const;
+};
+
+template <typename FuncType>
+void FDiskGrid::WalkSegment(const FVector2D& Start, const FVector2D& End, FuncType&& Visit) const
+{
+    if (Num() == 0) return;
+
+    const FVector2D Dir = End - Start;
+    const FVector2D Max = Min + FVector2D(Columns * CellSize, Rows * CellSize);
+
+    // Clip the segment (parameter T in [0, 1]) to the grid rectangle.
+    double TEnter = 0.0;
+    double TExit  = 1.0;
+    auto ClipAxis = [&TEnter, &TExit](double S, double D, double Lo, double Hi)
+    {
+        if (FMath::Abs(D) < UE_KINDA_SMALL_NUMBER) return S >= Lo && S <= Hi;
+
+        double T0 = (Lo - S) / D;
+        double T1 = (Hi - S) / D;
+        if (T0 > T1) Swap(T0, T1);
+        TEnter = FMath::Max(TEnter, T0);
+        TExit  = FMath::Min(TExit, T1);
+        return TEnter <= TExit;
+    };
+    if (!ClipAxis(Start.X, Dir.X, Min.X, Max.X)) return;
+    if (!ClipAxis(Start.Y, Dir.Y, Min.Y, Max.Y)) return;
+
+    const FVector2D Entry = Start + Dir * TEnter;
+    int32 Col = FMath::Clamp(FMath::FloorToInt32((Entry.X - Min.X) / CellSize), 0, Columns - 1);
+    int32 Row = FMath::Clamp(FMath::FloorToInt32((Entry.Y - Min.Y) / CellSize), 0, Rows - 1);
+
+    // Amanatides-Woo: T at which the segment crosses the next cell boundary on each axis.
+    const int32  StepX   = Dir.X > 0.0 ? 1 : (Dir.X < 0.0 ? -1 : 0);
+    const int32  StepY   = Dir.Y > 0.0 ? 1 : (Dir.Y < 0.0 ? -1 : 0);
+    const double TDeltaX = StepX ? CellSize / FMath::Abs(Dir.X) : UE_BIG_NUMBER;
+    const double TDeltaY = StepY ? CellSize / FMath::Abs(Dir.Y) : UE_BIG_NUMBER;
+    double TMaxX = StepX ? (Min.X + (Col + (StepX > 0 ? 1 : 0)) * CellSize - Start.X) / Dir.X : UE_BIG_NUMBER;
+    double TMaxY = StepY ? (Min.Y + (Row + (StepY > 0 ? 1 : 0)) * CellSize - Start.Y) / Dir.Y : UE_BIG_NUMBER;
+
+    while (true)
+    {
+        if (!Visit(Col + Row * Columns)) return;
+
+        if (TMaxX < TMaxY)
+        {
+            if (TMaxX > TExit) return;
+            Col += StepX;
+            TMaxX += TDeltaX;
+        }
+        else
+        {
+            if (TMaxY > TExit) return;
+            Row += StepY;
+            TMaxY += TDeltaY;
+        }
+
+        if (Col < 0 || Col >= Columns || Row < 0 || Row >= Rows) return;
+    }
+}
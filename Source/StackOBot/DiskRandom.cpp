@@ -0,0 +1,29 @@
+#include "DiskRandom.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+void FDiskRandom::GenerateSpeeds(uint32 Seed, int32 FirstSlot, TConstArrayView<uint32> SpawnCounts,
+    float MinSpeed, float MaxSpeed, TArrayView<float> OutSpeeds)
+{
+    check(SpawnCounts.Num() == OutSpeeds.Num());
+
+    constexpr int32 BlockSize = 4096;
+    const int32 NumBlocks = FMath::DivideAndRoundUp(OutSpeeds.Num(), BlockSize);
+
+    // Each element depends only on its own counter, so blocks can run in any order.
+    ParallelFor(NumBlocks, [&](int32 Block)
+    {
+        const int32 Begin = Block * BlockSize;
+        const int32 End   = FMath::Min(Begin + BlockSize, OutSpeeds.Num());
+        for (int32 i = Begin; i < End; ++i)
+        {
+            OutSpeeds[i] = Speed(Seed, FirstSlot + i, SpawnCounts[i], MinSpeed, MaxSpeed);
+        }
+    }, NumBlocks <= 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+uint32 FDiskRandom::MakeSessionSeed()
+{
+    const uint32 Seed = static_cast<uint32>(Mix(FPlatformTime::Cycles64()));
+    return Seed != 0 ? Seed : 1;
+}
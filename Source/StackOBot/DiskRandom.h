@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Stateless, counter-based random stream for disk speeds (SplitMix64 finalizer).
+ * The value for (Seed, Slot, SpawnCount) is computed directly, so any slot's sequence can be
+ * evaluated independently, in O(1), in any order and on any thread.
+ *
+ * Slot is the disk's index in FDiskSimulation, which spans every layer. It is not a grid cell:
+ * after a resize a cell that moved to another index draws from that index's substream.
+ */
+struct FDiskRandom
+{
+    static FORCEINLINE uint64 Mix(uint64 Z)
+    {
+        Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+        return Z ^ (Z >> 31);
+    }
+
+    /** 64 random bits for draw SpawnCount of Slot's substream. */
+    static FORCEINLINE uint64 Bits(uint32 Seed, uint32 Slot, uint32 SpawnCount)
+    {
+        constexpr uint64 Golden = 0x9E3779B97F4A7C15ull;
+        const uint64 StreamKey = Mix(((static_cast<uint64>(Seed) << 32) | Slot) + Golden);
+        return Mix(StreamKey + (static_cast<uint64>(SpawnCount) + 1) * Golden);
+    }
+
+    /** Uniform float in [0, 1) from the top 24 bits. */
+    static FORCEINLINE float Unit(uint64 InBits)
+    {
+        return static_cast<float>(InBits >> 40) * (1.f / 16777216.f);
+    }
+
+    static FORCEINLINE float Speed(uint32 Seed, int32 Slot, uint32 SpawnCount, float MinSpeed, float MaxSpeed)
+    {
+        return FMath::Lerp(MinSpeed, MaxSpeed, Unit(Bits(Seed, Slot, SpawnCount)));
+    }
+
+    /**
+     * Batch form: OutSpeeds[i] = Speed(Seed, FirstSlot + i, SpawnCounts[i], ...).
+     * Large batches are split across worker threads; the result does not depend on the split.
+     */
+    static void GenerateSpeeds(uint32 Seed, int32 FirstSlot, TConstArrayView<uint32> SpawnCounts,
+        float MinSpeed, float MaxSpeed, TArrayView<float> OutSpeeds);
+
+    /** A fresh non-zero seed for sessions that did not ask for a fixed one. */
+    static uint32 MakeSessionSeed();
+};
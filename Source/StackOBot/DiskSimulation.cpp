@@ -0,0 +1,678 @@
+#include "DiskSimulation.h"
+#include "DiskRandom.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    constexpr int32 MaskWordBits = 32;
+
+    // Lower bound on a falling disk's speed: a positive speed is what marks it Falling in Step.
+    constexpr float MinFallSpeed = UE_KINDA_SMALL_NUMBER;
+
+    // Word due times are worked out against a floor this far above the real one, so the floor
+    // can rise that much with the players before they all have to be recomputed.
+    constexpr float DueFloorSlack = 256.f;
+
+    // A word is only skipped this long before its due time, so rounding in the division can
+    // never skip a disk the sweep's own compare would have caught.
+    constexpr float DueTimeMargin = 1e-3f;
+
+    const auto GreenHeapOrder = [](const auto& A, const auto& B) { return A.Z > B.Z; };
+}
+
+void FDiskSimulation::Reset(int32 NumDisks, int32 InNumLayers)
+{
+    NumLayers     = FMath::Max(InNumLayers, 1);
+    CellsPerLayer = FMath::Max(NumDisks / NumLayers, 1);
+    check(NumDisks % NumLayers == 0);
+
+    Heights.SetNumZeroed(NumDisks);
+    BaseHeights.SetNumZeroed(NumDisks);
+    AnchorTimes.SetNumZeroed(NumDisks);
+    Speeds.SetNumZeroed(NumDisks);
+    StoredSpeeds.SetNumZeroed(NumDisks);
+    States.Init(EDiskState::Falling, NumDisks);
+    Epochs.SetNumZeroed(NumDisks);
+    SpawnCounts.SetNumZeroed(NumDisks);
+    SpawnTimes.SetNumZeroed(NumDisks);
+    RespawnMask.SetNumZeroed(FMath::DivideAndRoundUp(NumDisks, MaskWordBits));
+    WordDueTimes.Init(-UE_MAX_FLT, RespawnMask.Num());
+    EventArena.SetNumUninitialized(NumDisks);
+
+    // Room for every disk to change state twice in each Tick before the owner drains them.
+    Events.Reserve(2 * NumDisks * FMath::Max(TicksPerDrain, 1));
+
+    SimTime    = 0.0;
+    TimeBase   = 0.0;
+    HeightBase = 0.0;
+    BottomBand = 0;
+    RedIndices.Reset();
+    NumRed   = 0;
+    NumGreen = 0;
+    Events.Reset();
+    GreenHeap.Reset();
+    GreenHeap.Reserve(2 * NumDisks + 1);   // PushGreen compacts past 2 * Num()
+    RespawnFloorZ = -UE_BIG_NUMBER;
+    DueFloorZ     = -UE_BIG_NUMBER;
+    Difficulty.Reset(CellsPerLayer);
+}
+
+void FDiskSimulation::SerializeState(FArchive& Ar)
+{
+    int32 NumDisks = Num();
+    int32 Layers   = NumLayers;
+    Ar << NumDisks << Layers;
+    if (Ar.IsLoading())
+    {
+        if (NumDisks < 0 || Layers < 1 || NumDisks % Layers != 0)
+        {
+            Ar.SetError();
+            Reset(0);
+            return;
+        }
+        Reset(NumDisks, Layers);
+    }
+
+    Ar << Config.GroundZ << Config.RespawnBelowOffset << Config.SpawnHeightOffset;
+    Ar << Config.MinSpeed << Config.MaxSpeed << Config.LayerSpacing << Config.Seed;
+    Ar << SimTime << TimeBase << HeightBase << BottomBand;
+
+    Ar << Heights << BaseHeights << AnchorTimes << Speeds << StoredSpeeds << SpawnCounts << RedIndices;
+    static_assert(sizeof(EDiskState) == 1, "States are serialized as bytes");
+    Ar.Serialize(States.GetData(), NumDisks);
+    Difficulty.Serialize(Ar);
+
+    if (Ar.IsLoading())
+    {
+        const bool bSizesMatch = Heights.Num() == NumDisks && BaseHeights.Num() == NumDisks && AnchorTimes.Num() == NumDisks
+            && Speeds.Num() == NumDisks && StoredSpeeds.Num() == NumDisks && SpawnCounts.Num() == NumDisks
+            && Difficulty.CellScales.Num() == CellsPerLayer;
+        if (!bSizesMatch)
+        {
+            Ar.SetError();
+            Reset(0);
+            return;
+        }
+        RebuildStateIndex();
+    }
+}
+
+void FDiskSimulation::Tick(float DeltaTime, TConstArrayView<FDiskPlayer> Players)
+{
+    SetPlayers(Players);
+    if (SortedPlayerZ.Num() == 0) return;
+
+    // The owner sees the move in HeightBase and passes later players relative to it.
+    RebaseNear(SortedPlayerZ.Last());
+
+    const float LowestZ  = SortedPlayerZ[0];
+    const float HighestZ = SortedPlayerZ.Last();
+
+    // Respawn if the disk hit the floor OR drifted too far below every player.
+    SetRespawnFloor(FMath::Max(ToLocalZ(Config.GroundZ), LowestZ - Config.RespawnBelowOffset));
+
+    // Fall and respawn only touch the chunk's own cells, so chunks run independently.
+    const int32 N         = Num();
+    const int32 ChunkSize = Align(FMath::Max(DisksPerTask, MaskWordBits), MaskWordBits);
+    const int32 NumChunks = FMath::DivideAndRoundUp(N, ChunkSize);
+
+    // Advanced first, so disks respawned by this tick are stamped later than anything
+    // (e.g. an in-flight shot) that happened before it.
+    AdvanceTime(DeltaTime);
+    const float Now = LocalTime();
+
+    // Heights in world units, so the controller's history survives a rebase.
+    if (Difficulty.Config.bEnabled)
+    {
+        for (int32 Slot = 0; Slot < SlotPlayerZ.Num(); ++Slot)
+        {
+            if (SlotPlayerZ[Slot] > -UE_BIG_NUMBER) Difficulty.TrackPlayer(Slot, ToWorldZ(SlotPlayerZ[Slot]));
+        }
+        Difficulty.Advance(SimTime);
+    }
+    const int32 FirstEvent = Events.Num();
+
+    // Recycled layers respawn before the sweep, which then evaluates them where they landed.
+    if (NumLayers > 1)
+        StreamLayers(HighestZ);
+    else
+        LayerSpawnZ.Init(HighestZ + Config.SpawnHeightOffset, 1);
+
+    ChunkEventCounts.SetNumUninitialized(NumChunks, EAllowShrinking::No);
+
+    ParallelFor(NumChunks, [this, N, ChunkSize, Now](int32 Chunk)
+    {
+        const int32 Begin = Chunk * ChunkSize;
+        const int32 End   = FMath::Min(Begin + ChunkSize, N);
+
+        StepRange(Begin, End, Now);
+        ChunkEventCounts[Chunk] = RespawnRange(Begin, End, EventArena.GetData() + Begin);
+    }, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+        Events.Append(EventArena.GetData() + Chunk * ChunkSize, ChunkEventCounts[Chunk]);
+
+    // Per cell, so it stays off the chunks: layers of one cell can land in different chunks.
+    if (Difficulty.Config.bEnabled)
+    {
+        for (int32 i = FirstEvent; i < Events.Num(); ++i)
+        {
+            if (Events[i].Type == EDiskEvent::Respawned || Events[i].Type == EDiskEvent::Recycled)
+                Difficulty.OnRespawn(CellOf(Events[i].Index));
+        }
+    }
+
+    // A red disk turns green once its owner climbs above it. Owners missing this tick keep theirs.
+    for (int32 Slot = 0; Slot < RedIndices.Num(); ++Slot)
+    {
+        const int32 Red = RedIndices[Slot];
+        if (Red != INDEX_NONE && SlotPlayerZ.IsValidIndex(Slot) && SlotPlayerZ[Slot] > Heights[Red])
+        {
+            Promote(Red);
+            Events.Add({ Red, EDiskEvent::Promoted });
+            RedIndices[Slot] = INDEX_NONE;
+        }
+    }
+
+    // Green disks resume falling the moment no player is left above them.
+    IndexScratch.Reset();
+    CollectGreenAbove(HighestZ, IndexScratch);
+    for (const int32 i : IndexScratch)
+    {
+        Unfreeze(i);
+        Events.Add({ i, EDiskEvent::Unfrozen });
+    }
+}
+
+bool FDiskSimulation::HitDisk(int32 Index, float PlayerZ, int32 Slot)
+{
+    if (!States.IsValidIndex(Index) || States[Index] != EDiskState::Falling || Slot < 0) return false;
+
+    if (Heights[Index] > PlayerZ)
+    {
+        while (RedIndices.Num() <= Slot) RedIndices.Add(INDEX_NONE);
+
+        // Each player holds one red disk; a new one releases the previous.
+        if (RedIndices[Slot] != INDEX_NONE)
+        {
+            Unfreeze(RedIndices[Slot]);
+            Events.Add({ RedIndices[Slot], EDiskEvent::Unfrozen });
+        }
+        Freeze(Index, EDiskState::FrozenRed);
+        Events.Add({ Index, EDiskEvent::FrozenRed });
+        RedIndices[Slot] = Index;
+    }
+    else
+    {
+        Freeze(Index, EDiskState::FrozenGreen);
+        Events.Add({ Index, EDiskEvent::FrozenGreen });
+    }
+    Difficulty.AddShot(CellOf(Index), true);
+    return true;
+}
+
+void FDiskSimulation::MissShot()
+{
+    Difficulty.AddShot(INDEX_NONE, false);
+}
+
+void FDiskSimulation::SetPlayers(TConstArrayView<FDiskPlayer> Players)
+{
+    SortedPlayerZ.Reset();
+    SlotPlayerZ.Reset();
+    for (const FDiskPlayer& Player : Players)
+    {
+        if (Player.Slot < 0) continue;
+
+        SortedPlayerZ.Add(Player.Z);
+        while (SlotPlayerZ.Num() <= Player.Slot) SlotPlayerZ.Add(-UE_BIG_NUMBER);
+        SlotPlayerZ[Player.Slot] = Player.Z;
+    }
+    SortedPlayerZ.Sort();
+}
+
+void FDiskSimulation::ReleasePlayer(int32 Slot)
+{
+    Difficulty.ReleasePlayer(Slot);
+    if (!RedIndices.IsValidIndex(Slot) || RedIndices[Slot] == INDEX_NONE) return;
+
+    Unfreeze(RedIndices[Slot]);
+    Events.Add({ RedIndices[Slot], EDiskEvent::Unfrozen });
+    RedIndices[Slot] = INDEX_NONE;
+}
+
+int32 FDiskSimulation::GetRedOwner(int32 Index) const
+{
+    return RedIndices.Find(Index);
+}
+
+float FDiskSimulation::GetSpawnZ(int32 Index, float FallbackZ) const
+{
+    if (NumLayers > 1)
+        return BandTopZ(BandOfLayer(LayerOf(Index)));
+
+    return GetHighestPlayerZ(FallbackZ) + Config.SpawnHeightOffset;
+}
+
+void FDiskSimulation::PlaceLayers(float FallbackZ)
+{
+    BottomBand = TopBandFor(GetHighestPlayerZ(FallbackZ)) - NumLayers + 1;
+}
+
+float FDiskSimulation::RebaseNear(float Z)
+{
+    if (FMath::Abs(Z) <= RebaseDistance) return 0.f;
+
+    // Whole steps keep quantized heights exact through the subtraction.
+    const float Shift = FMath::GridSnap(Z, RebaseDistance);
+    HeightBase += Shift;
+
+    for (float& Height : Heights)     Height -= Shift;
+    for (float& Height : BaseHeights) Height -= Shift;
+    for (FGreenEntry& Entry : GreenHeap) Entry.Z -= Shift;   // Same shift for all, so still a heap
+    for (float& PlayerZ : SortedPlayerZ) PlayerZ -= Shift;
+    for (float& PlayerZ : SlotPlayerZ)
+    {
+        if (PlayerZ > -UE_BIG_NUMBER) PlayerZ -= Shift;
+    }
+    if (RespawnFloorZ > -UE_BIG_NUMBER) RespawnFloorZ -= Shift;
+    if (DueFloorZ > -UE_BIG_NUMBER)     DueFloorZ     -= Shift;   // Due times are unchanged by the shift
+
+    return Shift;
+}
+
+int32 FDiskSimulation::TopBandFor(float Z) const
+{
+    const double Spacing = FMath::Max(Config.LayerSpacing, 1.f);
+    return FMath::FloorToInt32((ToWorldZ(Z) + Config.SpawnHeightOffset) / Spacing);
+}
+
+float FDiskSimulation::BandTopZ(int32 Band) const
+{
+    const double Spacing = FMath::Max(Config.LayerSpacing, 1.f);
+    return ToLocalZ((Band + 1) * Spacing);
+}
+
+void FDiskSimulation::StreamLayers(float HighestZ)
+{
+    const int32 OldBottom = BottomBand;
+    BottomBand = TopBandFor(HighestZ) - NumLayers + 1;
+
+    LayerSpawnZ.SetNum(NumLayers);
+    for (int32 Layer = 0; Layer < NumLayers; ++Layer)
+        LayerSpawnZ[Layer] = BandTopZ(BandOfLayer(Layer));
+
+    // Each band left behind hands its layer to the band NumLayers above. Going down only
+    // relabels the bands; the disks already in the air keep falling.
+    const int32 NumRecycled = FMath::Min(BottomBand - OldBottom, NumLayers);
+    for (int32 i = 0; i < NumRecycled; ++i)
+        RecycleLayer(LayerOfBand(OldBottom + i));
+}
+
+void FDiskSimulation::RecycleLayer(int32 Layer)
+{
+    // Falling disks below the floor would respawn this tick anyway; the frozen ones are the
+    // steps nobody can reach any more. Red disks sit above their owner, so are never this low.
+    const int32 Begin = Layer * CellsPerLayer;
+    for (int32 i = Begin; i < Begin + CellsPerLayer; ++i)
+    {
+        if (Heights[i] >= RespawnFloorZ || States[i] == EDiskState::FrozenRed) continue;
+
+        const bool bWasFrozen = States[i] != EDiskState::Falling;
+        Spawn(i, LayerSpawnZ[Layer], RandomSpeed(i));
+        Events.Add({ i, bWasFrozen ? EDiskEvent::Recycled : EDiskEvent::Respawned });
+    }
+}
+
+float FDiskSimulation::RandomSpeed(int32 Index) const
+{
+    // Keyed by (seed, disk index, respawn count): reproducible and independent of call order.
+    // The index spans all layers and is renumbered by a resize, so it is a slot, not a cell.
+    return FDiskRandom::Speed(Config.Seed, Index, SpawnCounts[Index], Config.MinSpeed, Config.MaxSpeed)
+        * Difficulty.GetCellScale(CellOf(Index));
+}
+
+void FDiskSimulation::Remap(TConstArrayView<int32> OldIndexOf, int32 InNumLayers)
+{
+    const TArray<float>      OldHeights      = MoveTemp(Heights);
+    const TArray<float>      OldBaseHeights  = MoveTemp(BaseHeights);
+    const TArray<float>      OldAnchorTimes  = MoveTemp(AnchorTimes);
+    const TArray<float>      OldSpeeds       = MoveTemp(Speeds);
+    const TArray<float>      OldStoredSpeeds = MoveTemp(StoredSpeeds);
+    const TArray<EDiskState> OldStates       = MoveTemp(States);
+    const TArray<uint32>     OldSpawnCounts  = MoveTemp(SpawnCounts);
+    const TArray<double>     OldSpawnTimes   = MoveTemp(SpawnTimes);
+    const double             OldTime         = SimTime;
+    const double             OldTimeBase     = TimeBase;
+    const double             OldHeightBase   = HeightBase;
+    const int32              OldBottomBand   = BottomBand;
+    const float              OldFloor        = RespawnFloorZ;
+    const TArray<int32>      OldRedIndices   = MoveTemp(RedIndices);
+    const int32              OldLayerSize    = CellsPerLayer;
+    FDiskDifficulty          OldDifficulty   = MoveTemp(Difficulty);
+
+    Reset(OldIndexOf.Num(), InNumLayers);
+    SimTime    = OldTime;
+    TimeBase   = OldTimeBase;
+    HeightBase = OldHeightBase;
+    BottomBand = OldBottomBand;
+    RedIndices.Init(INDEX_NONE, OldRedIndices.Num());   // Reds on removed cells are dropped
+
+    // The controller keeps what it learned; surviving cells keep their scale, new ones start at 1.
+    const TArray<float> OldCellScales = MoveTemp(OldDifficulty.CellScales);
+    Difficulty = MoveTemp(OldDifficulty);
+    Difficulty.CellScales.Init(1.f, CellsPerLayer);
+
+    for (int32 i = 0; i < OldIndexOf.Num(); ++i)
+    {
+        const int32 Old = OldIndexOf[i];
+        if (Old == INDEX_NONE) continue;
+        for (int32 Slot = 0; Slot < OldRedIndices.Num(); ++Slot)
+        {
+            if (OldRedIndices[Slot] == Old) RedIndices[Slot] = i;
+        }
+
+        Heights[i]      = OldHeights[Old];
+        BaseHeights[i]  = OldBaseHeights[Old];
+        AnchorTimes[i]  = OldAnchorTimes[Old];
+        Speeds[i]       = OldSpeeds[Old];
+        StoredSpeeds[i] = OldStoredSpeeds[Old];
+        States[i]       = OldStates[Old];
+        SpawnCounts[i]  = OldSpawnCounts[Old];
+        SpawnTimes[i]   = OldSpawnTimes[Old];
+
+        const int32 OldCell = Old % OldLayerSize;
+        if (OldCellScales.IsValidIndex(OldCell))
+            Difficulty.CellScales[CellOf(i)] = OldCellScales[OldCell];
+    }
+
+    // Indices changed, so the green heap is rebuilt against the new layout.
+    SetRespawnFloor(OldFloor);
+    RebuildStateIndex();
+}
+
+void FDiskSimulation::Spawn(int32 Index, float Z, float Speed)
+{
+    Speed = FMath::Max(Speed, MinFallSpeed);
+
+    // Respawns only ever see Falling disks, so the chunked path in Tick never writes the counts.
+    if (States[Index] != EDiskState::Falling) LeaveState(States[Index]);
+
+    Heights[Index]      = Z;
+    BaseHeights[Index]  = Z;
+    AnchorTimes[Index]  = LocalTime();
+    Speeds[Index]       = Speed;
+    StoredSpeeds[Index] = Speed;
+    States[Index]       = EDiskState::Falling;
+    ++Epochs[Index];
+    ++SpawnCounts[Index];
+    SpawnTimes[Index] = SimTime;
+    NoteFall(Index);
+}
+
+void FDiskSimulation::Freeze(int32 Index, EDiskState FrozenState)
+{
+    BaseHeights[Index]  = Heights[Index];   // Evaluated at SimTime by the last Step
+    StoredSpeeds[Index] = Speeds[Index];
+    Speeds[Index]       = 0.f;   // Holds it in place through Step
+    States[Index]       = FrozenState;
+    ++Epochs[Index];
+    EnterState(FrozenState);
+    if (FrozenState == EDiskState::FrozenGreen) PushGreen(Index);
+}
+
+void FDiskSimulation::Promote(int32 Index)
+{
+    LeaveState(States[Index]);
+    States[Index] = EDiskState::FrozenGreen;
+    ++Epochs[Index];
+    EnterState(EDiskState::FrozenGreen);
+    PushGreen(Index);
+}
+
+void FDiskSimulation::Unfreeze(int32 Index)
+{
+    LeaveState(States[Index]);
+
+    // The fall restarts from where it froze, now.
+    BaseHeights[Index] = Heights[Index];
+    AnchorTimes[Index] = LocalTime();
+    Speeds[Index]      = StoredSpeeds[Index];
+    States[Index]      = EDiskState::Falling;
+    ++Epochs[Index];
+    NoteFall(Index);
+}
+
+void FDiskSimulation::Assign(int32 Index, float Z, float Speed, EDiskState State)
+{
+    LeaveState(States[Index]);
+
+    const bool bFalling = State == EDiskState::Falling;
+    Heights[Index]     = Z;
+    BaseHeights[Index] = Z;
+    AnchorTimes[Index] = LocalTime();
+    Speeds[Index]  = bFalling ? FMath::Max(Speed, MinFallSpeed) : 0.f;
+    if (bFalling) StoredSpeeds[Index] = Speeds[Index];
+    States[Index]  = State;
+    ++Epochs[Index];
+
+    EnterState(State);
+    if (bFalling) NoteFall(Index);
+}
+
+void FDiskSimulation::SetRespawnFloor(float FloorZ)
+{
+    RespawnFloorZ = FloorZ;
+
+    // Due times stay lower bounds while the floor is at or below DueFloorZ. Rising past it, or
+    // dropping so far that they are needlessly early, resets every word to be swept in full once.
+    if (FloorZ > DueFloorZ || FloorZ < DueFloorZ - 2.f * DueFloorSlack)
+    {
+        DueFloorZ = FloorZ + DueFloorSlack;
+        for (float& Due : WordDueTimes) Due = -UE_MAX_FLT;
+    }
+}
+
+void FDiskSimulation::NoteFall(int32 Index)
+{
+    if (Speeds[Index] <= 0.f) return;
+
+    float& Due = WordDueTimes[Index / MaskWordBits];
+    Due = FMath::Min(Due, AnchorTimes[Index] + (BaseHeights[Index] - DueFloorZ) / Speeds[Index]);
+}
+
+void FDiskSimulation::Step(float DeltaTime)
+{
+    AdvanceTime(DeltaTime);
+    StepRange(0, Num(), LocalTime());
+}
+
+void FDiskSimulation::AdvanceTime(float DeltaTime)
+{
+    SimTime += DeltaTime;
+
+    // Float seconds keep sub-0.1 ms resolution up to 512 s; past that, measure from now instead.
+    const float Elapsed = LocalTime();
+    if (Elapsed < 512.f) return;
+
+    for (float& Anchor : AnchorTimes)
+        Anchor -= Elapsed;
+    for (float& Due : WordDueTimes)
+    {
+        if (FMath::Abs(Due) < UE_MAX_FLT) Due -= Elapsed;
+    }
+    TimeBase = SimTime;
+}
+
+void FDiskSimulation::StepRange(int32 Begin, int32 End, float Now)
+{
+    checkSlow(Begin % MaskWordBits == 0);
+
+    float*       Z      = Heights.GetData();
+    const float* Base   = BaseHeights.GetData();
+    const float* Anchor = AnchorTimes.GetData();
+    const float* Speed  = Speeds.GetData();
+    uint32*      Mask   = RespawnMask.GetData();
+
+    float*       DueTimes = WordDueTimes.GetData();
+
+    // Frozen disks have Speed == 0: they stay at their base height and fail the Speed > 0
+    // test, so the sweep treats every disk alike. Each word of the mask covers eight 4-wide
+    // registers.
+    //
+    // Each word also keeps the earliest time any of its falling disks can reach the floor
+    // (DueTimes). A word with no falling disk is skipped outright, since frozen heights never
+    // move. A word not yet due only has its heights refreshed for the owner to draw. Only due
+    // words run the floor test, and they work out their next due time while at it.
+    const VectorRegister4Float VecNow      = VectorSetFloat1(Now);
+    const VectorRegister4Float VecFloor    = VectorSetFloat1(RespawnFloorZ);
+    const VectorRegister4Float VecDueFloor = VectorSetFloat1(DueFloorZ);
+    const VectorRegister4Float VecNever    = VectorSetFloat1(UE_MAX_FLT);
+    const VectorRegister4Float VecZero     = VectorZeroFloat();
+
+    for (int32 Word = Begin / MaskWordBits, i = Begin; i < End; ++Word)
+    {
+        const int32 WordEnd = FMath::Min(i + MaskWordBits, End);
+        Mask[Word] = 0;
+
+        if (DueTimes[Word] == UE_MAX_FLT)
+        {
+            i = WordEnd;
+            continue;
+        }
+
+        if (Now < DueTimes[Word] - DueTimeMargin)
+        {
+            for (; i + 4 <= WordEnd; i += 4)
+            {
+                const VectorRegister4Float Elapsed = VectorSubtract(VecNow, VectorLoad(Anchor + i));
+                VectorStore(VectorNegateMultiplyAdd(VectorLoad(Speed + i), Elapsed, VectorLoad(Base + i)), Z + i);
+            }
+            for (; i < WordEnd; ++i)
+                Z[i] = Base[i] - Speed[i] * (Now - Anchor[i]);
+            continue;
+        }
+
+        uint32 Bits = 0;
+        VectorRegister4Float VecDue = VecNever;
+
+        for (; i + 4 <= WordEnd; i += 4)
+        {
+            const VectorRegister4Float V       = VectorLoad(Speed + i);
+            const VectorRegister4Float A       = VectorLoad(Anchor + i);
+            const VectorRegister4Float B       = VectorLoad(Base + i);
+            const VectorRegister4Float NewZ    = VectorNegateMultiplyAdd(V, VectorSubtract(VecNow, A), B);
+            VectorStore(NewZ, Z + i);
+
+            const VectorRegister4Float Falling = VectorCompareGT(V, VecZero);
+            const VectorRegister4Float Due     = VectorBitwiseAnd(VectorCompareLT(NewZ, VecFloor), Falling);
+            Bits |= static_cast<uint32>(VectorMaskBits(Due)) << (i % MaskWordBits);
+
+            // Frozen lanes divide by zero; the select drops whatever that gives.
+            const VectorRegister4Float Crossing = VectorAdd(A, VectorDivide(VectorSubtract(B, VecDueFloor), V));
+            VecDue = VectorMin(VecDue, VectorSelect(Falling, Crossing, VecNever));
+        }
+
+        alignas(16) float Lanes[4];
+        VectorStoreAligned(VecDue, Lanes);
+        float WordDue = FMath::Min(FMath::Min(Lanes[0], Lanes[1]), FMath::Min(Lanes[2], Lanes[3]));
+
+        // Scalar tail when N is not a multiple of 4.
+        for (; i < WordEnd; ++i)
+        {
+            Z[i] = Base[i] - Speed[i] * (Now - Anchor[i]);
+            Bits |= static_cast<uint32>(Z[i] < RespawnFloorZ && Speed[i] > 0.f) << (i % MaskWordBits);
+            if (Speed[i] > 0.f)
+                WordDue = FMath::Min(WordDue, Anchor[i] + (Base[i] - DueFloorZ) / Speed[i]);
+        }
+
+        // Disks respawned from this mask lower it again through NoteFall.
+        Mask[Word]     = Bits;
+        DueTimes[Word] = WordDue;
+    }
+}
+
+int32 FDiskSimulation::RespawnRange(int32 Begin, int32 End, FDiskEvent* OutEvents)
+{
+    int32 NumEvents = 0;
+    const int32 LastWord = FMath::DivideAndRoundUp(End, MaskWordBits);
+    for (int32 Word = Begin / MaskWordBits; Word < LastWord; ++Word)
+    {
+        for (uint32 Bits = RespawnMask[Word]; Bits != 0; Bits &= Bits - 1)
+        {
+            const int32 i = Word * MaskWordBits + static_cast<int32>(FMath::CountTrailingZeros(Bits));
+            Spawn(i, LayerSpawnZ[LayerOf(i)], RandomSpeed(i));
+            OutEvents[NumEvents++] = { i, EDiskEvent::Respawned };
+        }
+    }
+    return NumEvents;
+}
+
+void FDiskSimulation::CollectRespawns(TArray<int32>& OutIndices) const
+{
+    for (int32 Word = 0; Word < RespawnMask.Num(); ++Word)
+    {
+        for (uint32 Bits = RespawnMask[Word]; Bits != 0; Bits &= Bits - 1)
+        {
+            OutIndices.Add(Word * MaskWordBits + static_cast<int32>(FMath::CountTrailingZeros(Bits)));
+        }
+    }
+}
+
+void FDiskSimulation::CollectGreenAbove(float PlayerZ, TArray<int32>& OutIndices)
+{
+    // Only the disks the player actually dropped below are popped.
+    while (GreenHeap.Num() > 0 && GreenHeap.HeapTop().Z > PlayerZ)
+    {
+        FGreenEntry Top;
+        GreenHeap.HeapPop(Top, GreenHeapOrder, EAllowShrinking::No);
+
+        if (Epochs[Top.Index] == Top.Epoch && States[Top.Index] == EDiskState::FrozenGreen)
+            OutIndices.Add(Top.Index);
+    }
+}
+
+void FDiskSimulation::RebuildStateIndex()
+{
+    // The fall of any disk may have changed: every word is swept in full once.
+    WordDueTimes.Init(-UE_MAX_FLT, RespawnMask.Num());
+
+    GreenHeap.Reset();
+    NumRed   = 0;
+    NumGreen = 0;
+
+    for (int32 i = 0; i < Num(); ++i)
+    {
+        EnterState(States[i]);
+        if (States[i] == EDiskState::FrozenGreen) PushGreen(i);
+    }
+}
+
+void FDiskSimulation::LeaveState(EDiskState State)
+{
+    NumRed   -= State == EDiskState::FrozenRed;
+    NumGreen -= State == EDiskState::FrozenGreen;
+}
+
+void FDiskSimulation::EnterState(EDiskState State)
+{
+    NumRed   += State == EDiskState::FrozenRed;
+    NumGreen += State == EDiskState::FrozenGreen;
+}
+
+void FDiskSimulation::PushGreen(int32 Index)
+{
+    // Stale entries below the player are only popped once they come within reach, so drop
+    // them in bulk before the heap outgrows the grid.
+    if (GreenHeap.Num() > 2 * Num())
+    {
+        GreenHeap.RemoveAllSwap([this](const FGreenEntry& Entry)
+        {
+            return Epochs[Entry.Index] != Entry.Epoch || States[Entry.Index] != EDiskState::FrozenGreen;
+        }, EAllowShrinking::No);
+        GreenHeap.Heapify(GreenHeapOrder);
+    }
+
+    GreenHeap.HeapPush(FGreenEntry{ Heights[Index], Index, Epochs[Index] }, GreenHeapOrder);
+}
@@ -0,0 +1,307 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiskFieldTypes.h"
+#include "DiskDifficulty.h"
+
+/** Rule tuning; ADiskSpawner copies its UPROPERTYs in here. */
+struct FDiskFieldConfig
+{
+    float  GroundZ            = -123.f;
+    float  RespawnBelowOffset = 400.f;
+    float  SpawnHeightOffset  = 3000.f;
+    float  MinSpeed           = 150.f;
+    float  MaxSpeed           = 500.f;
+    float  LayerSpacing       = 1000.f;   // Height band per layer when the field has more than one
+    uint32 Seed               = 1;
+};
+
+/** A state change made by the rules, for the owner to mirror onto actors or instances. */
+enum class EDiskEvent : uint8
+{
+    Respawned,
+    FrozenRed,
+    FrozenGreen,
+    Promoted,
+    Unfrozen,
+    Recycled,   // A frozen disk respawned with its layer after the players climbed away from it
+};
+
+struct FDiskEvent
+{
+    int32      Index;
+    EDiskEvent Type;
+};
+
+/** A player the field reacts to. Slot is stable while the player stays; each slot owns at most one red disk. */
+struct FDiskPlayer
+{
+    int32 Slot;
+    float Z;
+};
+
+/**
+ * Headless disk-field core: structure-of-arrays state for every disk plus the game rules
+ * (fall, respawn, red/green freeze, promotion, unfreeze) for any number of players, each
+ * holding its own red disk. No UWorld or UObject dependency,
+ * so it can be driven by ADiskSpawner in game or by a commandlet for benchmarking.
+ * Element i belongs to grid cell i % CellsPerLayer (Col + Row * GridColumns) of layer
+ * i / CellsPerLayer, so each layer is a contiguous block.
+ *
+ * A disk's fall is stored in closed form: Z = BaseHeight - Speed * (t - AnchorTime), re-anchored
+ * only when it spawns, freezes or unfreezes. Heights is that formula evaluated at SimTime, so
+ * it never accumulates integration error however many steps ran. Refreshing it and the
+ * respawn check are one SIMD sweep that leaves a bit per disk in RespawnMask. Frozen disks
+ * carry a zero speed, so the sweep needs no branch on state. The sweep skips work per 32-disk
+ * word: a word with no falling disk is not touched at all, and a word none of whose disks can
+ * reach the floor yet (WordDueTimes, a lower bound kept by Spawn/Unfreeze) skips the floor test.
+ *
+ * Frozen-green disks sit in a height-ordered heap, so only the ones the player dropped below
+ * are looked at.
+ *
+ * Players enter a Tick as one height-sorted list: the respawn floor comes from its first entry
+ * and the spawn height and green unfreeze from its last, so the per-disk pass costs the same
+ * for 32 players as for one. Red promotion looks each owner up by slot. Green disks are
+ * shared: one unfreezes only once every player is below it (with one player, once that player
+ * falls below it), so a green step stays up while anyone can still stand on it.
+ *
+ * Tick splits the sweep and the respawns into cell-range chunks run with ParallelFor. Each
+ * chunk records its own events in its slice of a per-disk arena and the slices are appended
+ * in chunk order, so Events is the same as a single-threaded run. Every buffer is sized by
+ * Reset, so a steady Tick does not touch the heap.
+ *
+ * With more than one layer the field streams vertically. The layers form a ring over
+ * consecutive height bands of LayerSpacing: band b belongs to layer b % NumLayers, and each
+ * layer respawns its disks at the top of its band. The stack follows the highest player. A
+ * band left behind hands its layer to the band NumLayers above, and the stranded frozen disks
+ * in it move up with it, so the disk count is fixed however high the players climb.
+ *
+ * Heights are stored relative to HeightBase, which moves up in whole RebaseDistance steps as
+ * the players climb, so floats keep their precision at any altitude.
+ *
+ * With Difficulty.Config.bEnabled, every respawn speed is scaled by its cell's entry in the
+ * difficulty controller, which Tick, HitDisk and MissShot keep fed.
+ */
+struct FDiskSimulation
+{
+    TArray<float>      Heights;        // World Z of each disk at SimTime, evaluated from the two below
+    TArray<float>      BaseHeights;    // World Z at AnchorTime
+    TArray<float>      AnchorTimes;    // Seconds after TimeBase at which the disk was at BaseHeight
+    TArray<float>      Speeds;         // Current fall speed (UU/s); 0 while frozen
+    TArray<float>      StoredSpeeds;   // Memorized when frozen; restored on Unfreeze
+    TArray<EDiskState> States;
+    TArray<uint32>     Epochs;         // Bumped on every state change; invalidates queued events
+    TArray<uint32>     SpawnCounts;    // Spawns so far per disk; the counter of its random substream
+    TArray<double>     SpawnTimes;     // SimTime of each disk's last Spawn
+
+    double SimTime  = 0.0;
+    double TimeBase = 0.0;   // Origin of AnchorTimes; moved up now and then to keep them small
+    double HeightBase = 0.0; // World Z of height 0; Heights, BaseHeights and player Z are relative to it
+
+    int32 NumLayers     = 1;
+    int32 CellsPerLayer = 0;
+    int32 BottomBand    = 0; // Lowest height band of the layer stack (bands are LayerSpacing apart from world Z 0)
+
+    /** Players this far from HeightBase move it, in steps of this size. */
+    static constexpr float RebaseDistance = 65536.f;
+
+    /** Closed-form height of disk Index at simulation time Time, valid while its state holds. */
+    float HeightAt(int32 Index, double Time) const
+    {
+        return BaseHeights[Index] - Speeds[Index] * (static_cast<float>(Time - TimeBase) - AnchorTimes[Index]);
+    }
+
+    FDiskFieldConfig   Config;
+    FDiskDifficulty    Difficulty;              // Per-cell speed scaling tuned from the players' performance
+    TArray<int32>      RedIndices;              // Per player slot: that player's FrozenRed disk, or INDEX_NONE
+    int32              NumRed   = 0;            // FrozenRed / FrozenGreen disks, kept current by the state changes
+    int32              NumGreen = 0;
+    TArray<FDiskEvent> Events;                  // Appended by Tick and HitDisk; drained by the owner
+
+    /** Disks per ParallelFor task in Tick; rounded up to whole mask words. Fields this size or smaller stay on the calling thread. */
+    int32 DisksPerTask = 4096;
+
+    /** Most Ticks the owner runs before draining Events. Reset reserves room for that many, so the drain never regrows it. */
+    int32 TicksPerDrain = 1;
+
+    int32 Num() const { return Heights.Num(); }
+
+    int32 CellOf(int32 Index) const  { return Index % CellsPerLayer; }
+    int32 LayerOf(int32 Index) const { return Index / CellsPerLayer; }
+
+    double ToWorldZ(float Z) const       { return HeightBase + Z; }
+    float  ToLocalZ(double WorldZ) const { return static_cast<float>(WorldZ - HeightBase); }
+
+    /** Resize every buffer to NumDisks falling disks at Z = 0, split into InNumLayers equal layers. */
+    void Reset(int32 NumDisks, int32 InNumLayers = 1);
+
+    /**
+     * Rebuild the buffers for a resized grid. New disk i takes old disk OldIndexOf[i]'s state;
+     * disks mapped to INDEX_NONE are left empty and must be Spawn()ed by the caller.
+     */
+    void Remap(TConstArrayView<int32> OldIndexOf, int32 InNumLayers = 1);
+
+    /**
+     * Save or load everything the rules depend on: config, clock, per-disk state and red
+     * owners. Loading replaces the field and rebuilds the derived counts and heap.
+     */
+    void SerializeState(FArchive& Ar);
+
+    // ── Rules ──────────────────────────────────────────────────────────────────
+
+    /**
+     * One frame of the field: fall, respawn disks below the lowest player's floor (above the
+     * highest player), promote each red disk once its owner is above it, and unfreeze the green
+     * disks every player has dropped below. Does nothing without players.
+     */
+    void Tick(float DeltaTime, TConstArrayView<FDiskPlayer> Players);
+
+    /** Single-player Tick (slot 0). */
+    void Tick(float DeltaTime, float PlayerZ)
+    {
+        const FDiskPlayer Solo{ 0, PlayerZ };
+        Tick(DeltaTime, MakeArrayView(&Solo, 1));
+    }
+
+    /**
+     * Sort Players by height and index them by slot. Tick does this itself; call it before the
+     * first Tick so the initial spawns already go above the players.
+     */
+    void SetPlayers(TConstArrayView<FDiskPlayer> Players);
+
+    /** Highest player in the last Tick, or Fallback if it had none. */
+    float GetHighestPlayerZ(float Fallback) const
+    {
+        return SortedPlayerZ.Num() > 0 ? SortedPlayerZ.Last() : Fallback;
+    }
+
+    /** Where disk Index spawns: the top of its layer's band, or above the highest player (FallbackZ without players) on a single layer. */
+    float GetSpawnZ(int32 Index, float FallbackZ) const;
+
+    /** Stack the layers' bands above the highest player (FallbackZ without players) without moving any disk. */
+    void PlaceLayers(float FallbackZ);
+
+    /**
+     * Move HeightBase by whole RebaseDistance steps if Z (relative) is more than RebaseDistance
+     * from it. Every stored height shifts by the same amount. Returns the shift, or 0.
+     */
+    float RebaseNear(float Z);
+
+    /**
+     * Laser hit by the player in Slot: a falling disk above PlayerZ becomes that player's red
+     * disk (their previous one resumes falling), one at or below it freezes green. Returns false
+     * if the disk wasn't falling.
+     */
+    bool HitDisk(int32 Index, float PlayerZ, int32 Slot = 0);
+
+    /** A laser shot that hit no disk; counts against the players' accuracy in Difficulty. */
+    void MissShot();
+
+    /** The player in Slot left: their red disk resumes falling. */
+    void ReleasePlayer(int32 Slot);
+
+    /** Slot of the player holding disk Index as their red disk, or INDEX_NONE. */
+    int32 GetRedOwner(int32 Index) const;
+
+    /** Next speed of disk Index's random substream, scaled by its cell's Difficulty entry. */
+    float RandomSpeed(int32 Index) const;
+
+    // ── Low-level state changes (no events) ────────────────────────────────────
+
+    /** Place disk Index at Z with a fresh (positive) speed and set it Falling. */
+    void Spawn(int32 Index, float Z, float Speed);
+
+    /** Freeze disk Index as FrozenRed or FrozenGreen, memorizing its speed and zeroing it. */
+    void Freeze(int32 Index, EDiskState FrozenState);
+
+    /** FrozenRed -> FrozenGreen; the stored speed is kept. */
+    void Promote(int32 Index);
+
+    /** Restore the stored speed and resume falling. */
+    void Unfreeze(int32 Index);
+
+    /**
+     * Overwrite disk Index with state decided elsewhere (a network client mirroring the server).
+     * No rules run; the owner records whatever event the change represents.
+     */
+    void Assign(int32 Index, float Z, float Speed, EDiskState State);
+
+    /** Set the Z below which falling disks respawn (ground or player-relative, whichever is higher). */
+    void SetRespawnFloor(float FloorZ);
+
+    /**
+     * Advance the clock by DeltaTime, re-evaluate every disk's height and mark the falling ones
+     * now below the respawn floor, in one vectorized pass.
+     */
+    void Step(float DeltaTime);
+
+    /** Append the disks the last Step marked for respawn, in index order. */
+    void CollectRespawns(TArray<int32>& OutIndices) const;
+
+    /** Append the frozen-green disks above PlayerZ, i.e. the ones the player just fell below. */
+    void CollectGreenAbove(float PlayerZ, TArray<int32>& OutIndices);
+
+private:
+    struct FGreenEntry
+    {
+        float  Z;
+        int32  Index;
+        uint32 Epoch;
+    };
+
+    TArray<FGreenEntry> GreenHeap;     // Max-heap on Z
+    TArray<uint32>      RespawnMask;   // Bit i%32 of word i/32: disk i is due for respawn
+    TArray<float>       WordDueTimes;  // Per mask word: earliest local time a falling disk in it can reach DueFloorZ; UE_MAX_FLT if none falls
+    TArray<int32>       IndexScratch;
+    TArray<FDiskEvent> EventArena;       // One slot per disk; each chunk writes its respawns into its own range
+    TArray<int32>      ChunkEventCounts; // Events each chunk wrote, merged in chunk order
+
+    float RespawnFloorZ = -UE_BIG_NUMBER;
+    float DueFloorZ     = -UE_BIG_NUMBER;   // Floor WordDueTimes are measured against; never below RespawnFloorZ
+
+    TArray<float> SortedPlayerZ;   // Last Tick's player heights, ascending
+    TArray<float> SlotPlayerZ;     // Last Tick's height per slot; -UE_BIG_NUMBER for empty slots
+
+    /** Evaluate disks [Begin, End) at Now (seconds after TimeBase) and mark respawns; Begin must be word aligned. */
+    void StepRange(int32 Begin, int32 End, float Now);
+
+    /** SimTime - TimeBase, the clock AnchorTimes are measured on. */
+    float LocalTime() const { return static_cast<float>(SimTime - TimeBase); }
+
+    /** Advance SimTime, moving TimeBase up once the anchors would start losing float precision. */
+    void AdvanceTime(float DeltaTime);
+
+    /**
+     * Respawn the disks in [Begin, End) that StepRange marked at their layer's LayerSpawnZ,
+     * writing an event for each to OutEvents (room for End - Begin). Returns the count.
+     */
+    int32 RespawnRange(int32 Begin, int32 End, FDiskEvent* OutEvents);
+
+    TArray<float> LayerSpawnZ;   // This Tick's respawn height per layer
+
+    int32 LayerOfBand(int32 Band) const { return ((Band % NumLayers) + NumLayers) % NumLayers; }
+    int32 BandOfLayer(int32 Layer) const { return BottomBand + (Layer - LayerOfBand(BottomBand) + NumLayers) % NumLayers; }
+
+    /** Band the top of the stack should be in for a highest player at Z. */
+    int32 TopBandFor(float Z) const;
+
+    /** Relative Z of the top of Band. */
+    float BandTopZ(int32 Band) const;
+
+    /** Follow the highest player up (recycling the layers left behind) or down. */
+    void StreamLayers(float HighestZ);
+
+    /** Respawn every disk of Layer below the respawn floor, except red ones, at the layer's spawn height. */
+    void RecycleLayer(int32 Layer);
+
+    /** Bring disk Index's word due time forward to cover the fall it just started. */
+    void NoteFall(int32 Index);
+
+    /** Recount NumRed/NumGreen and rebuild the green heap after the arrays were rewritten. */
+    void RebuildStateIndex();
+    void PushGreen(int32 Index);
+
+    /** Keep NumRed/NumGreen current as a disk leaves / enters State. */
+    void LeaveState(EDiskState State);
+    void EnterState(EDiskState State);
+};
@@ -0,0 +1,145 @@
+#include "DiskSoakBotController.h"
+#include "DiskSpawner.h"
+#include "DiskFieldSubsystem.h"
+#include "ShootingComponent.h"
+
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+
+namespace
+{
+    constexpr float ClimbGraceTime = 0.25f;   // Time for the shot at the step to land
+    constexpr float ClimbTimeout   = 5.f;     // Give up on a step not reached by then
+}
+
+ADiskSoakBotController::ADiskSoakBotController()
+{
+    PrimaryActorTick.bCanEverTick = true;
+}
+
+void ADiskSoakBotController::SetSeed(int32 Seed)
+{
+    Random.Initialize(Seed);
+
+    // Bots spawned together would otherwise all fire on the same frame.
+    FireCooldown = Random.FRand() / FMath::Max(FireRate, UE_KINDA_SMALL_NUMBER);
+}
+
+void ADiskSoakBotController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+    Shooter = InPawn ? InPawn->FindComponentByClass<UShootingComponent>() : nullptr;
+}
+
+void ADiskSoakBotController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    ACharacter*   Bot     = GetPawn<ACharacter>();
+    ADiskSpawner* Spawner = UDiskFieldSubsystem::FindSpawner(this);
+    if (!Bot || !Spawner || !Shooter) return;
+
+    // A climber holds fire while it has a step: a new red disk would release the one it is on its way to.
+    FireCooldown = FMath::Max(FireCooldown - DeltaSeconds, -1.f / FMath::Max(FireRate, UE_KINDA_SMALL_NUMBER));
+    if (Policy == EDiskSoakPolicy::GreedyClimb && ClimbCell != INDEX_NONE)
+    {
+        Climb(*Spawner, *Bot, DeltaSeconds);
+        return;
+    }
+
+    if (FireCooldown > 0.f || FireRate <= 0.f) return;
+    FireCooldown += 1.f / FireRate;
+
+    const FVector Eyes  = Bot->GetPawnViewLocation();
+    const float   FeetZ = Bot->GetActorLocation().Z - Bot->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+    const int32   Cell  = PickTarget(*Spawner, Eyes, FeetZ);
+    if (Cell == INDEX_NONE) return;
+
+    // Fire() shoots along the control rotation from the pawn's eyes.
+    SetControlRotation((Spawner->GetDiskLocation(Cell) - Eyes).Rotation());
+    Shooter->Fire();
+    ++NumShots;
+
+    if (Policy == EDiskSoakPolicy::GreedyClimb)
+    {
+        ClimbCell = Cell;
+        ClimbAge  = 0.f;
+    }
+}
+
+int32 ADiskSoakBotController::PickTarget(const ADiskSpawner& Spawner, const FVector& Eyes, float FeetZ)
+{
+    Candidates.Reset();
+    Spawner.GetDisksInRadius(Eyes, SearchRadius, Candidates);
+    Candidates.RemoveAllSwap([&Spawner, FeetZ](int32 Cell)
+    {
+        return Spawner.GetDiskState(Cell) != EDiskState::Falling || Spawner.GetDiskLocation(Cell).Z <= FeetZ;
+    }, EAllowShrinking::No);
+    if (Candidates.Num() == 0) return INDEX_NONE;
+
+    switch (Policy)
+    {
+    case EDiskSoakPolicy::Random:
+        return Candidates[Random.RandHelper(Candidates.Num())];
+
+    case EDiskSoakPolicy::GreedyClimb:
+    {
+        // The next step up: low above the feet first, then close in XY.
+        int32 Best = INDEX_NONE;
+        double BestScore = TNumericLimits<double>::Max();
+        for (const int32 Cell : Candidates)
+        {
+            const FVector Disk  = Spawner.GetDiskLocation(Cell);
+            const double  Score = (Disk.Z - FeetZ) + 0.5 * FVector::Dist2D(Disk, Eyes);
+            if (Score < BestScore)
+            {
+                BestScore = Score;
+                Best      = Cell;
+            }
+        }
+        return Best;
+    }
+
+    case EDiskSoakPolicy::NearestAbove:
+    default:
+    {
+        int32 Best = INDEX_NONE;
+        double BestDistSq = TNumericLimits<double>::Max();
+        for (const int32 Cell : Candidates)
+        {
+            const double DistSq = FVector::DistSquared(Spawner.GetDiskLocation(Cell), Eyes);
+            if (DistSq < BestDistSq)
+            {
+                BestDistSq = DistSq;
+                Best       = Cell;
+            }
+        }
+        return Best;
+    }
+    }
+}
+
+void ADiskSoakBotController::Climb(const ADiskSpawner& Spawner, ACharacter& Bot, float DeltaSeconds)
+{
+    ClimbAge += DeltaSeconds;
+
+    // Missed (an async shot resolves a frame late), unfrozen under us, or out of reach.
+    const bool bLost = (Spawner.GetDiskState(ClimbCell) == EDiskState::Falling && ClimbAge > ClimbGraceTime)
+        || ClimbAge > ClimbTimeout;
+
+    const FVector Disk = Spawner.GetDiskLocation(ClimbCell);
+    const FVector Feet = Bot.GetActorLocation() - FVector(0.f, 0.f, Bot.GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+    // Stood on (or lost): pick the next step with the next shot.
+    if (bLost || (Feet.Z >= Disk.Z && FVector::Dist2D(Disk, Feet) < Bot.GetCapsuleComponent()->GetScaledCapsuleRadius()))
+    {
+        ClimbCell = INDEX_NONE;
+        return;
+    }
+
+    const FVector ToDisk = FVector(Disk.X - Feet.X, Disk.Y - Feet.Y, 0.f);
+    Bot.AddMovementInput(ToDisk.GetSafeNormal());
+
+    if (Disk.Z - Feet.Z < JumpReach && ToDisk.SizeSquared() < FMath::Square(2.f * JumpReach))
+        Bot.Jump();
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "DiskSoakBotController.generated.h"
+
+class ACharacter;
+class ADiskSpawner;
+class UShootingComponent;
+
+/** How a soak-test bot picks the disk to shoot. */
+UENUM()
+enum class EDiskSoakPolicy : uint8
+{
+    NearestAbove,   // Closest falling disk above the bot
+    Random,         // Any falling disk in reach
+    GreedyClimb,    // Lowest falling disk above the bot, then jump onto it once frozen
+};
+
+/**
+ * Scripted shooter for UDiskSoakTestSubsystem. Fires the pawn's UShootingComponent at
+ * FireRate shots per second at a disk chosen by Policy, aiming through the control rotation,
+ * and under GreedyClimb walks to and jumps onto the disk it froze. No navmesh or behaviour
+ * tree: the disks move too fast for either to help, and the point is to load the game loop.
+ */
+UCLASS()
+class STACKOBOT_API ADiskSoakBotController : public AAIController
+{
+    GENERATED_BODY()
+
+public:
+    ADiskSoakBotController();
+
+    virtual void Tick(float DeltaSeconds) override;
+
+    EDiskSoakPolicy Policy = EDiskSoakPolicy::NearestAbove;
+
+    /** Shots per second. */
+    float FireRate = 2.f;
+
+    /** Disks farther than this from the bot's eyes are not considered. */
+    float SearchRadius = 2500.f;
+
+    /** Highest disk top above its feet a GreedyClimb bot will jump for. */
+    float JumpReach = 250.f;
+
+    /** Seed the Random policy and the first shot's stagger from Seed. */
+    void SetSeed(int32 Seed);
+
+    int32 GetNumShots() const { return NumShots; }
+
+protected:
+    virtual void OnPossess(APawn* InPawn) override;
+
+private:
+    UPROPERTY()
+    TObjectPtr<UShootingComponent> Shooter;
+
+    FRandomStream Random;
+    TArray<int32> Candidates;   // Scratch for PickTarget
+    float FireCooldown = 0.f;
+    int32 ClimbCell    = INDEX_NONE;   // GreedyClimb: the disk being climbed onto
+    float ClimbAge     = 0.f;          // Seconds since ClimbCell was shot
+    int32 NumShots     = 0;
+
+    /** Disk to shoot from the bot's eye location, or INDEX_NONE if nothing suitable is in reach. */
+    int32 PickTarget(const ADiskSpawner& Spawner, const FVector& Eyes, float FeetZ);
+
+    /** Walk towards ClimbCell and jump when it is within reach; drop it once stood on or lost. */
+    void Climb(const ADiskSpawner& Spawner, ACharacter& Bot, float DeltaSeconds);
+};
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "DiskSoakTestSubsystem.h"
+#include "DiskSoakBotController.h"
+#include "DiskFieldSubsystem.h"
+#include "DiskSpawner.h"
+#include "ShootingComponent.h"
+
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    /** Value at fraction P of an ascending array (nearest rank). */
+    float Percentile(const TArray<float>& Sorted, float P)
+    {
+        if (Sorted.IsEmpty()) return 0.f;
+        return Sorted[FMath::Clamp(FMath::CeilToInt32(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+    }
+
+    bool ParsePolicy(const FString& Name, EDiskSoakPolicy& OutPolicy)
+    {
+        if      (Name == TEXT("Nearest")) OutPolicy = EDiskSoakPolicy::NearestAbove;
+        else if (Name == TEXT("Random"))  OutPolicy = EDiskSoakPolicy::Random;
+        else if (Name == TEXT("Greedy"))  OutPolicy = EDiskSoakPolicy::GreedyClimb;
+        else return false;
+        return true;
+    }
+}
+
+bool UDiskSoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return FParse::Param(FCommandLine::Get(), TEXT("DiskSoak")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UDiskSoakTestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDiskSoakTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const TCHAR* CmdLine = FCommandLine::Get();
+    FParse::Value(CmdLine, TEXT("SoakBots="), NumBots);
+    FParse::Value(CmdLine, TEXT("SoakMinutes="), Minutes);
+    FParse::Value(CmdLine, TEXT("SoakWarmup="), WarmupSeconds);
+    FParse::Value(CmdLine, TEXT("SoakFireRate="), FireRate);
+    FParse::Value(CmdLine, TEXT("SoakSeed="), Seed);
+    FParse::Value(CmdLine, TEXT("SoakPolicy="), PolicyName);
+    NumBots = FMath::Max(0, NumBots);
+    Minutes = FMath::Max(Minutes, 1.f / 60.f);
+
+    if (UDiskFieldSubsystem* DiskField = InWorld.GetSubsystem<UDiskFieldSubsystem>())
+        DiskEventsHandle = DiskField->OnDiskStateChanged.AddUObject(this, &UDiskSoakTestSubsystem::OnDiskEvents);
+    PreGCHandle  = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UDiskSoakTestSubsystem::OnPreGC);
+    PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UDiskSoakTestSubsystem::OnPostGC);
+
+    SpawnBots(InWorld);
+
+    if (const ADiskSpawner* Spawner = UDiskFieldSubsystem::FindSpawner(this))
+        HitsAtStart = Spawner->GetNumHits();
+
+    FrameMs.Reset();
+    FrameMs.Reserve(FMath::CeilToInt32(Minutes * 60.f * 60.f));   // 60 fps worth, so recording does not reallocate
+    SimSeconds  = 0.0;
+    LastFrameAt = FPlatformTime::Seconds();
+    bRunning    = true;
+
+    UE_LOG(LogTemp, Display, TEXT("DiskSoak: %d bots (%s) for %.1f simulated minutes"), Bots.Num(), *PolicyName, Minutes);
+}
+
+void UDiskSoakTestSubsystem::Deinitialize()
+{
+    if (UDiskFieldSubsystem* DiskField = GetWorld()->GetSubsystem<UDiskFieldSubsystem>())
+        DiskField->OnDiskStateChanged.Remove(DiskEventsHandle);
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+
+    Super::Deinitialize();
+}
+
+void UDiskSoakTestSubsystem::SpawnBots(UWorld& InWorld)
+{
+    AGameModeBase* GameMode = InWorld.GetAuthGameMode();
+    UClass* PawnClass = GameMode ? GameMode->DefaultPawnClass.Get() : nullptr;
+    if (!PawnClass)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DiskSoak: no default pawn class to spawn bots from"));
+        return;
+    }
+
+    EDiskSoakPolicy FixedPolicy = EDiskSoakPolicy::NearestAbove;
+    const bool bMixed = !ParsePolicy(PolicyName, FixedPolicy);
+    if (bMixed) PolicyName = TEXT("Mixed");
+
+    FTransform Start = FTransform::Identity;
+    if (TActorIterator<APlayerStart> It(&InWorld); It)
+        Start = It->GetActorTransform();
+
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    // A ring around the start, far enough apart that the capsules do not push each other off it.
+    const float Radius = 150.f + 40.f * NumBots;
+    for (int32 i = 0; i < NumBots; ++i)
+    {
+        const float   Angle    = 2.f * PI * i / NumBots;
+        const FVector Location = Start.GetLocation() + Radius * FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f);
+
+        APawn* Pawn = InWorld.SpawnActor<APawn>(PawnClass, Location, Start.Rotator(), Params);
+        if (!Pawn) continue;
+
+        if (!Pawn->FindComponentByClass<UShootingComponent>())
+        {
+            UShootingComponent* Shooter = NewObject<UShootingComponent>(Pawn, TEXT("SoakShooter"));
+            Shooter->RegisterComponent();
+        }
+
+        ADiskSoakBotController* Bot = InWorld.SpawnActor<ADiskSoakBotController>(Params);
+        if (!Bot)
+        {
+            Pawn->Destroy();
+            continue;
+        }
+        Bot->Policy   = bMixed ? static_cast<EDiskSoakPolicy>(i % 3) : FixedPolicy;
+        Bot->FireRate = FireRate;
+        Bot->SetSeed(Seed + i);
+        Bot->Possess(Pawn);
+        Bots.Add(Bot);
+    }
+}
+
+void UDiskSoakTestSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    if (!bRunning) return;
+
+    // Under -benchmark DeltaTime is the fixed step, so frame cost is measured on the wall clock.
+    const double Now = FPlatformTime::Seconds();
+    if (SimSeconds >= WarmupSeconds)
+        FrameMs.Add(static_cast<float>((Now - LastFrameAt) * 1000.0));
+    LastFrameAt = Now;
+
+    SimSeconds += DeltaTime;
+    if (SimSeconds >= Minutes * 60.0)
+        Finish();
+}
+
+TStatId UDiskSoakTestSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UDiskSoakTestSubsystem, STATGROUP_Tickables);
+}
+
+void UDiskSoakTestSubsystem::OnDiskEvents(TConstArrayView<FDiskEvent> Events)
+{
+    if (!bRunning) return;
+
+    for (const FDiskEvent& Event : Events)
+    {
+        if (Event.Type == EDiskEvent::Respawned || Event.Type == EDiskEvent::Recycled)
+            ++Respawns;
+    }
+}
+
+void UDiskSoakTestSubsystem::OnPreGC()
+{
+    GCStartedAt = FPlatformTime::Seconds();
+}
+
+void UDiskSoakTestSubsystem::OnPostGC()
+{
+    if (!bRunning || GCStartedAt == 0.0) return;
+
+    const double Ms = (FPlatformTime::Seconds() - GCStartedAt) * 1000.0;
+    ++NumGCs;
+    GCTotalMs  += Ms;
+    GCMaxMs     = FMath::Max(GCMaxMs, Ms);
+    GCStartedAt = 0.0;
+}
+
+void UDiskSoakTestSubsystem::Finish()
+{
+    bRunning = false;
+
+    int32 Shots = 0;
+    for (const ADiskSoakBotController* Bot : Bots)
+        if (Bot) Shots += Bot->GetNumShots();
+
+    // The spawner's own count, so red and green freezes both count and the report agrees with stat StackOBot.
+    const ADiskSpawner* Spawner = UDiskFieldSubsystem::FindSpawner(this);
+    const int32         Hits    = Spawner ? Spawner->GetNumHits() - HitsAtStart : 0;
+
+    TArray<float> Sorted = FrameMs;
+    Sorted.Sort();
+    double SumMs = 0.0;
+    for (float Ms : Sorted) SumMs += Ms;
+
+    const float  P50    = Percentile(Sorted, 0.50f);
+    const float  P90    = Percentile(Sorted, 0.90f);
+    const float  P99    = Percentile(Sorted, 0.99f);
+    const float  MaxMs  = Sorted.IsEmpty() ? 0.f : Sorted.Last();
+    const double MeanMs = Sorted.IsEmpty() ? 0.0 : SumMs / Sorted.Num();
+
+    const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+    const double PeakPhysicalMB = Memory.PeakUsedPhysical / (1024.0 * 1024.0);
+    const double PeakVirtualMB  = Memory.PeakUsedVirtual  / (1024.0 * 1024.0);
+
+    const FString Build = FString::Printf(TEXT("%s %s"), *FEngineVersion::Current().ToString(), LexToString(FApp::GetBuildConfiguration()));
+    const FString Stamp = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+    const FString Dir   = FPaths::ProjectSavedDir() / TEXT("Profiling");
+
+    const FString Json = FString::Printf(TEXT(
+        "{\n"
+        "  \"build\": \"%s\",\n"
+        "  \"bots\": %d,\n"
+        "  \"policy\": \"%s\",\n"
+        "  \"seed\": %d,\n"
+        "  \"simSeconds\": %.1f,\n"
+        "  \"frames\": %d,\n"
+        "  \"frameMs\": { \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f },\n"
+        "  \"respawns\": %d,\n"
+        "  \"shots\": %d,\n"
+        "  \"hits\": %d,\n"
+        "  \"peakPhysicalMB\": %.1f,\n"
+        "  \"peakVirtualMB\": %.1f,\n"
+        "  \"gc\": { \"count\": %d, \"totalMs\": %.3f, \"maxMs\": %.3f }\n"
+        "}\n"),
+        *Build, Bots.Num(), *PolicyName, Seed, SimSeconds, Sorted.Num(), P50, P90, P99, MaxMs, MeanMs,
+        Respawns, Shots, Hits, PeakPhysicalMB, PeakVirtualMB, NumGCs, GCTotalMs, GCMaxMs);
+    const FString JsonPath = Dir / FString::Printf(TEXT("DiskSoak-%s.json"), *Stamp);
+    FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+    const FString CsvPath = Dir / TEXT("DiskSoak.csv");
+    FString Csv;
+    if (!FPaths::FileExists(CsvPath))
+        Csv = TEXT("Time,Build,Bots,Policy,Seed,SimSeconds,Frames,P50Ms,P90Ms,P99Ms,MaxMs,MeanMs,Respawns,Shots,Hits,PeakPhysicalMB,PeakVirtualMB,GCs,GCTotalMs,GCMaxMs\n");
+    Csv += FString::Printf(TEXT("%s,%s,%d,%s,%d,%.1f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%.1f,%.1f,%d,%.3f,%.3f\n"),
+        *Stamp, *Build, Bots.Num(), *PolicyName, Seed, SimSeconds, Sorted.Num(), P50, P90, P99, MaxMs, MeanMs,
+        Respawns, Shots, Hits, PeakPhysicalMB, PeakVirtualMB, NumGCs, GCTotalMs, GCMaxMs);
+    FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+        &IFileManager::Get(), FILEWRITE_Append);
+
+    UE_LOG(LogTemp, Display, TEXT("DiskSoak: %d frames  p50 %.2f ms  p90 %.2f ms  p99 %.2f ms  max %.2f ms  %d respawns  %d shots  %d hits  peak %.0f MB  %d GCs (max %.2f ms)"),
+        Sorted.Num(), P50, P90, P99, MaxMs, Respawns, Shots, Hits, PeakPhysicalMB, NumGCs, GCMaxMs);
+    UE_LOG(LogTemp, Display, TEXT("DiskSoak: wrote %s and appended to %s"), *JsonPath, *CsvPath);
+
+    FPlatformMisc::RequestExit(false, TEXT("DiskSoak"));
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DiskSimulation.h"
+#include "DiskSoakTestSubsystem.generated.h"
+
+class ADiskSoakBotController;
+
+/**
+ * Bot-driven soak test, active only when the game is launched with -DiskSoak. On BeginPlay it
+ * spawns -SoakBots=N pawns of the game mode's default class around the player start, each
+ * possessed by an ADiskSoakBotController firing its UShootingComponent by -SoakPolicy
+ * (Nearest, Random, Greedy or Mixed). After -SoakMinutes of simulated time it writes a report
+ * to Saved/Profiling and quits: frame time percentiles, respawns, shots, hits, peak memory and
+ * GC pauses, as JSON per run plus one row appended to DiskSoak.csv.
+ *
+ *   UnrealEditor StackOBot.uproject -game -nullrhi -unattended -nosound -benchmark -fps=60
+ *       -DiskSoak -SoakBots=16 -SoakMinutes=10 [-SoakPolicy=Mixed] [-SoakSeed=1] [-SoakFireRate=2]
+ */
+UCLASS()
+class STACKOBOT_API UDiskSoakTestSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    // ── Options ───────────────────────────────────────────────────────
+    int32   NumBots       = 8;
+    float   Minutes       = 5.f;
+    float   WarmupSeconds = 5.f;    // Frame times before this are not counted (loading hitches)
+    float   FireRate      = 2.f;
+    int32   Seed          = 1;
+    FString PolicyName    = TEXT("Mixed");
+
+    // ── Run state ─────────────────────────────────────────────────────
+    UPROPERTY()
+    TArray<TObjectPtr<ADiskSoakBotController>> Bots;
+
+    bool          bRunning    = false;
+    double        SimSeconds  = 0.0;
+    double        LastFrameAt = 0.0;   // Wall clock, FPlatformTime::Seconds
+    TArray<float> FrameMs;             // Wall-clock frame times after warmup
+
+    int32 Respawns    = 0;
+    int32 HitsAtStart = 0;   // ADiskSpawner::GetNumHits when the run began
+
+    int32  NumGCs      = 0;
+    double GCStartedAt = 0.0;
+    double GCTotalMs   = 0.0;
+    double GCMaxMs     = 0.0;
+
+    FDelegateHandle DiskEventsHandle;
+    FDelegateHandle PreGCHandle;
+    FDelegateHandle PostGCHandle;
+
+    void SpawnBots(UWorld& InWorld);
+    void OnDiskEvents(TConstArrayView<FDiskEvent> Events);
+    void OnPreGC();
+    void OnPostGC();
+
+    /** Write the JSON report and the CSV row, then ask the engine to exit. */
+    void Finish();
+};
\ No newline at end of file
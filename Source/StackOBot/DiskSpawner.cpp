@@ -1,31 +1,135 @@
 #include "DiskSpawner.h"
 #include "PlayerHUDWidget.h"
+#include "DiskFieldProfiler.h"
+#include "DiskFieldSubsystem.h"
 
 #include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
 #include "GameFramework/PlayerController.h"
+#include "GameFramework/GameStateBase.h"
 #include "Blueprint/UserWidget.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
 #include "Kismet/GameplayStatics.h"
 #include "Math/UnrealMathUtility.h"
+#include "Async/ParallelFor.h"
+#include "Net/UnrealNetwork.h"
+#include "DiskRandom.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Misc/MemStack.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disks Falling"), STAT_DiskField_NumFalling, STATGROUP_StackOBot);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disks Red"),     STAT_DiskField_NumRed,     STATGROUP_StackOBot);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disks Green"),   STAT_DiskField_NumGreen,   STATGROUP_StackOBot);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disks Near"),    STAT_DiskField_NumNear,    STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Difficulty Scale"), STAT_DiskField_DifficultyScale, STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Climb Rate"),       STAT_DiskField_ClimbRate,       STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Accuracy"),         STAT_DiskField_Accuracy,        STATGROUP_StackOBot);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Falls / min"),      STAT_DiskField_FallRate,        STATGROUP_StackOBot);
+
+TRACE_DECLARE_INT_COUNTER(DiskField_NumFalling, TEXT("StackOBot/Disks falling"));
+TRACE_DECLARE_INT_COUNTER(DiskField_NumRed,     TEXT("StackOBot/Disks red"));
+TRACE_DECLARE_INT_COUNTER(DiskField_NumGreen,   TEXT("StackOBot/Disks green"));
+TRACE_DECLARE_INT_COUNTER(DiskField_NumNear,    TEXT("StackOBot/Disks near"));
+TRACE_DECLARE_FLOAT_COUNTER(DiskField_DifficultyScale, TEXT("StackOBot/Difficulty scale"));
+
+namespace
+{
+    FAutoConsoleCommandWithWorld ReplayStartCommand(
+        TEXT("StackOBot.Replay.Start"),
+        TEXT("Start recording the disk field (server only). Replay it with -run=DiskFieldReplay."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (ADiskSpawner* Spawner = UDiskFieldSubsystem::FindSpawner(World))
+                Spawner->StartReplayRecording();
+        }));
+
+    FAutoConsoleCommandWithWorld ReplayStopCommand(
+        TEXT("StackOBot.Replay.Stop"),
+        TEXT("Stop recording the disk field and write the file to Saved/Replays/."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (ADiskSpawner* Spawner = UDiskFieldSubsystem::FindSpawner(World))
+                Spawner->StopReplayRecording();
+        }));
+}
 
 // ������ Constructor ������������������������������������������������������������������������������������������������������������������������������
 ADiskSpawner::ADiskSpawner()
 {
     PrimaryActorTick.bCanEverTick = true;
+
+    // Every client sees the whole field, so skip the relevancy checks.
+    bReplicates     = true;
+    bAlwaysRelevant = true;
+
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+    // Only populated when bUseInstancedDisks is set. A plain ISM rather than a HISM: every
+    // instance moves each frame, which would keep rebuilding a HISM's cluster tree.
+    DiskInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("DiskInstances"));
+    DiskInstances->SetupAttachment(RootComponent);
+    DiskInstances->SetMobility(EComponentMobility::Movable);
+    DiskInstances->NumCustomDataFloats = 1;   // [0] = EDiskState
+
+    // Same collision as AFallingDisk::DiskMesh so the player can stand on frozen instances.
+    DiskInstances->SetCollisionProfileName(TEXT("BlockAll"));
+    DiskInstances->SetNotifyRigidBodyCollision(true);
+}
+
+void ADiskSpawner::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    NetDisks.Spawner = this;
+
+    // Before any BeginPlay, so shooters placed in the level can already find us.
+    if (UDiskFieldSubsystem* Subsystem = GetWorld()->GetSubsystem<UDiskFieldSubsystem>())
+        Subsystem->RegisterSpawner(this);
 }
 
 // ������ BeginPlay ����������������������������������������������������������������������������������������������������������������������������������
 void ADiskSpawner::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(StackOBot);
     Super::BeginPlay();
 
     CachedPlayer = Cast<ACharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+    if (HasAuthority())
+    {
+        // So the first disks already spawn above the players.
+        RegisterPlayer(CachedPlayer);
+        TArray<FDiskPlayer, TInlineAllocator<32>> InitialPlayers;
+        GatherPlayers(InitialPlayers);
+        Simulation.SetPlayers(InitialPlayers);
+    }
     // SpawnZ   = CachedPlayer ? CachedPlayer->GetActorLocation().Z : 0.f;
     SpawnZ = 0.0f;
     HighestZ = 0.f;   // Reset to 0 every session; tracks height gained, not world Z
 
+    SyncSimulationConfig();
+    Simulation.Config.Seed = Seed != 0 ? static_cast<uint32>(Seed) : FDiskRandom::MakeSessionSeed();
+    UE_LOG(LogTemp, Log, TEXT("ADiskSpawner: disk seed %d (set Seed to this value to replay the session)"),
+        GetActiveSeed());
+
+    DiskInstances->OnComponentHit.AddDynamic(this, &ADiskSpawner::OnInstancedDiskHit);
     SpawnAllDisks();
 
+    if (HasAuthority())
+    {
+        ReplicatedGridSize = FIntVector(GridColumns, GridRows, GridLayers);
+        RebuildNetDisks();
+        if (bRecordReplay)
+            StartReplayRecording();
+    }
+    else
+    {
+        ApplyAllNetDisks();   // Items that arrived before the disks existed
+    }
+
     APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
     if (PC)
     {
@@ -49,43 +153,346 @@ void ADiskSpawner::BeginPlay()
 }
 
 // ������ Tick ��������������������������������������������������������������������������������������������������������������������������������������������
+void ADiskSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UDiskFieldSubsystem* Subsystem = GetWorld()->GetSubsystem<UDiskFieldSubsystem>())
+        Subsystem->UnregisterSpawner(this);
+
+    StopReplayRecording();
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ADiskSpawner::Tick(float DeltaTime)
 {
+    LLM_SCOPE_BYTAG(StackOBot);
     Super::Tick(DeltaTime);
 
-    if (!CachedPlayer) return;
+    DISKFIELD_PHASE_SCOPE(SpawnerTick);
+
+    // A client's pawn replicates in after BeginPlay, so keep looking until it has one.
+    if (!CachedPlayer)
+        CachedPlayer = Cast<ACharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+
+    SyncSimulationConfig();
+    StepSimulation(DeltaTime);
+    ApplySimulationEvents();
+    UpdateDiskSignificance();
+    PushDiskTransforms();
+    if (!bUseInstancedDisks)
+        TopUpPool(MaxPoolSpawnsPerFrame);
+
+    if (CachedPlayer)
+    {
+        const float PlayerZ   = CachedPlayer->GetActorLocation().Z;
+        const float RelativeZ = PlayerZ - SpawnZ;   // Height gained this session
+        if (RelativeZ > HighestZ) HighestZ = RelativeZ;
+
+        CheckWinCondition(PlayerZ);   // WinZ is still an absolute world-Z threshold
+        UpdateHUD(RelativeZ);         // HUD shows session-relative height
+    }
+
+    UpdateStats();
+}
+
+void ADiskSpawner::StepSimulation(float DeltaTime)
+{
+    DISKFIELD_PHASE_SCOPE(SimulationTick);
+
+    // Step lengths are the replay's quantized frame times whether recording or not, so a
+    // recorded session replays exactly.
+    const bool bFixedStep = SimulationHz > 0.f;
+    float StepTime = FDiskReplay::QuantizeDeltaTime(DeltaTime);
+    int32 NumSteps = 1;
+    if (bFixedStep)
+    {
+        StepTime = FMath::Max(FDiskReplay::QuantizeDeltaTime(1.f / SimulationHz), FDiskReplay::DeltaTimeStep);
+        StepAccumulator += DeltaTime;
+        NumSteps = FMath::FloorToInt32(StepAccumulator / StepTime);
+        StepAccumulator -= NumSteps * StepTime;
+        NumSteps = FMath::Min(NumSteps, MaxStepsPerFrame);   // A hitch's surplus is dropped
+    }
+
+    // Player heights are sampled once per frame and held for all of its steps.
+    TArray<FDiskPlayer, TInlineAllocator<32>> TickPlayers;
+    if (HasAuthority())
+        GatherPlayers(TickPlayers);
+
+    if (PrevHeights.Num() != Simulation.Num())
+        PrevHeights = Simulation.Heights;
+
+    for (int32 Step = 0; Step < NumSteps; ++Step)
+    {
+        if (bFixedStep)
+            PrevHeights = Simulation.Heights;
+
+        // The rules run in the headless core on the server; the actors/instances only mirror
+        // its events. Clients just keep their disks falling between the server's updates.
+        float Rebase = 0.f;
+        if (HasAuthority())
+        {
+            const double OldBase = Simulation.HeightBase;
+            Replay.RecordTick(StepTime, TickPlayers);
+            Simulation.Tick(StepTime, TickPlayers);
+            Rebase = static_cast<float>(Simulation.HeightBase - OldBase);
+        }
+        else
+        {
+            if (CachedPlayer)
+                Rebase = Simulation.RebaseNear(Simulation.ToLocalZ(CachedPlayer->GetActorLocation().Z));
+            Simulation.Step(StepTime);
+        }
+
+        // Heights held outside the simulation follow it when it moves its base.
+        if (Rebase != 0.f)
+        {
+            for (float& Z : PrevHeights) Z -= Rebase;
+            for (FDiskPlayer& Player : TickPlayers) Player.Z -= Rebase;
+        }
+
+        if (bFixedStep && HasAuthority())
+            ApplySweptKnockback();
+    }
+
+    RenderAlpha = bFixedStep ? StepAccumulator / StepTime : 1.f;
+}
+
+void ADiskSpawner::ApplySweptKnockback()
+{
+    for (const TWeakObjectPtr<ACharacter>& PlayerPtr : Players)
+    {
+        ACharacter* Player = PlayerPtr.Get();
+        if (!Player) continue;
+
+        float CapsuleRadius, CapsuleHalfHeight;
+        Player->GetCapsuleComponent()->GetScaledCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+        const FVector Location = Player->GetActorLocation();
+        const float   HeadZ    = Simulation.ToLocalZ(Location.Z + CapsuleHalfHeight);
+
+        // Cell centres within reach are exactly the disks overlapping the capsule in XY, one per layer.
+        KnockbackCells.Reset();
+        Grid.CellsInRadius(FVector2D(Location), CapsuleRadius + DiskRadius, KnockbackCells);
+        const float BottomOffset = DiskCenterOffsetZ - DiskHalfHeight;
+        int32 HitIndex = INDEX_NONE;
+        for (int32 i = 0; i < KnockbackCells.Num() && HitIndex == INDEX_NONE; ++i)
+        {
+            for (int32 Index = KnockbackCells[i]; Index < Simulation.Num(); Index += Simulation.CellsPerLayer)
+            {
+                if (Simulation.States[Index] != EDiskState::Falling) continue;
+
+                // The underside crossed the top of the head during this step, however long the frame was.
+                if (PrevHeights[Index] + BottomOffset >= HeadZ && Simulation.Heights[Index] + BottomOffset < HeadZ)
+                {
+                    HitIndex = Index;
+                    break;
+                }
+            }
+        }
 
-    const float PlayerZ   = CachedPlayer->GetActorLocation().Z;
-    const float RelativeZ = PlayerZ - SpawnZ;   // Height gained this session
-    if (RelativeZ > HighestZ) HighestZ = RelativeZ;
+        // One knockback per player per step
+        if (HitIndex != INDEX_NONE)
+        {
+            const AFallingDisk* Disk = Disks.IsValidIndex(HitIndex) ? Disks[HitIndex] : nullptr;
+            AFallingDisk::ApplyKnockback(Player, GetDiskLocation(HitIndex),
+                Disk ? Disk->KnockbackForce : InstanceKnockbackForce);
+        }
+    }
+}
 
-    CheckGroundHits();
-    CheckRedPromotion();
-    CheckGreenUnfreeze();
-    CheckWinCondition(PlayerZ);   // WinZ is still an absolute world-Z threshold
-    UpdateHUD(RelativeZ);         // HUD shows session-relative height
+void ADiskSpawner::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(ADiskSpawner, NetDisks);
+    DOREPLIFETIME(ADiskSpawner, ReplicatedGridSize);
 }
 
 // ������ Public ����������������������������������������������������������������������������������������������������������������������������������������
 
 void ADiskSpawner::NotifyDiskHit(AFallingDisk* HitDisk, ACharacter* Player)
 {
-    if (!HitDisk || !Player) return;
-    if (HitDisk->DiskState != EDiskState::Falling) return;
+    if (!HitDisk) return;
+
+    const int32 Index = HitDisk->CellIndex;
+    if (!Disks.IsValidIndex(Index) || Disks[Index] != HitDisk) return;
 
-    const float PlayerZ = Player->GetActorLocation().Z;
-    const float DiskZ = HitDisk->GetActorLocation().Z;
+    NotifyCellHit(Index, Player);
+}
+
+void ADiskSpawner::NotifyCellHit(int32 Index, ACharacter* Player)
+{
+    if (!Player || !HasAuthority()) return;
 
-    if (DiskZ > PlayerZ)
+    const int32 Slot    = RegisterPlayer(Player);
+    const float PlayerZ = FDiskReplay::QuantizeHeight(Simulation.ToLocalZ(Player->GetActorLocation().Z));
+    Replay.RecordHit(Index, PlayerZ, Slot);
+    if (Simulation.HitDisk(Index, PlayerZ, Slot))
     {
-        if (RedDisk && RedDisk != HitDisk) RedDisk->Unfreeze();
-        HitDisk->FreezeRed();
-        RedDisk = HitDisk;
+        ++NumHits;
+        DISKFIELD_COUNT(Hits, 1);
+        ApplySimulationEvents();
     }
-    else
+}
+
+void ADiskSpawner::NotifyShotMissed(ACharacter* Player)
+{
+    if (!Player || !HasAuthority()) return;
+
+    Replay.RecordMiss();
+    Simulation.MissShot();
+}
+
+int32 ADiskSpawner::RegisterPlayer(ACharacter* Player)
+{
+    if (!Player) return INDEX_NONE;
+
+    int32 Slot = Players.IndexOfByKey(Player);
+    if (Slot != INDEX_NONE) return Slot;
+
+    // Reuse a slot freed by UnregisterPlayer so RedIndices stays small.
+    Slot = Players.IndexOfByPredicate([](const TWeakObjectPtr<ACharacter>& Other) { return Other.IsExplicitlyNull(); });
+    if (Slot == INDEX_NONE)
+        return Players.Add(Player);
+
+    Players[Slot] = Player;
+    return Slot;
+}
+
+void ADiskSpawner::UnregisterPlayer(ACharacter* Player)
+{
+    const int32 Slot = Player ? Players.IndexOfByKey(Player) : INDEX_NONE;
+    if (Slot != INDEX_NONE)
+        ReleasePlayerSlot(Slot);
+}
+
+void ADiskSpawner::ReleasePlayerSlot(int32 Slot)
+{
+    Replay.RecordRelease(Slot);
+    Simulation.ReleasePlayer(Slot);
+    Players[Slot] = nullptr;
+}
+
+void ADiskSpawner::StartReplayRecording()
+{
+    if (!HasAuthority() || Simulation.Num() == 0) return;
+
+    StopReplayRecording();
+    Replay.Start(Simulation, ReplayCapacityKB * 1024, bReplayRecordEvents);
+}
+
+void ADiskSpawner::StopReplayRecording()
+{
+    if (!Replay.IsRecording()) return;
+
+    const FString FileName = FString::Printf(TEXT("DiskField-%s.dfreplay"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S-%s")));
+    Replay.Stop(FPaths::ProjectSavedDir() / TEXT("Replays") / FileName);
+}
+
+void ADiskSpawner::ApplyNetDisk(const FDiskNetItem& Item)
+{
+    const int32 Index = Item.Cell;
+    if (HasAuthority() || !Simulation.States.IsValidIndex(Index)) return;
+
+    // Items are only re-sent on a state change or respawn, so the old and new state tell which.
+    const EDiskState OldState = Simulation.States[Index];
+    Simulation.Assign(Index, Simulation.ToLocalZ(Item.GetZ(GetNetTime())), Item.GetSpeed(), Item.State);
+
+    EDiskEvent Type = EDiskEvent::Respawned;
+    switch (Item.State)
+    {
+    case EDiskState::Falling:     Type = OldState == EDiskState::Falling ? EDiskEvent::Respawned : EDiskEvent::Unfrozen; break;
+    case EDiskState::FrozenRed:   Type = EDiskEvent::FrozenRed; break;
+    case EDiskState::FrozenGreen: Type = OldState == EDiskState::FrozenRed ? EDiskEvent::Promoted : EDiskEvent::FrozenGreen; break;
+    }
+    Simulation.Events.Add({ Index, Type });
+}
+
+int32 ADiskSpawner::GetDiskCellFromHit(const FHitResult& Hit) const
+{
+    if (bUseInstancedDisks)
+    {
+        const bool bIsDisk = Hit.GetComponent() == DiskInstances.Get() && Simulation.States.IsValidIndex(Hit.Item);
+        return bIsDisk ? Hit.Item : INDEX_NONE;
+    }
+
+    const AFallingDisk* Disk = Cast<AFallingDisk>(Hit.GetActor());
+    const bool bIsDisk = Disk && Disks.IsValidIndex(Disk->CellIndex) && Disks[Disk->CellIndex] == Disk;
+    return bIsDisk ? Disk->CellIndex : INDEX_NONE;
+}
+
+bool ADiskSpawner::RaycastDisks(const FVector& Start, const FVector& End, FDiskRayHit& OutHit) const
+{
+    const FVector Dir = End - Start;
+    bool bFound = false;
+
+    auto TestCell = [&](int32 Cell)
+    {
+        for (int32 Index = Cell; Index < Simulation.Num(); Index += Simulation.CellsPerLayer)
+        {
+            float Time;
+            if (!RayHitsDisk(Index, Start, Dir, Time) || (bFound && Time >= OutHit.Time)) continue;
+
+            OutHit.Cell = Index;
+            OutHit.Time = Time;
+            OutHit.ImpactPoint = Start + Dir * Time;
+            bFound = true;
+        }
+    };
+
+    // When each disk fits inside its own cell, the first cell with a hit holds the nearest disk
+    // and only that cell's layers are compared. Wider disks overhang their neighbours, so every
+    // cell within DiskOverhangCells of the walk is tested and the walk runs to the end.
+    Grid.WalkSegment(FVector2D(Start), FVector2D(End), [&](int32 Cell)
+    {
+        if (DiskOverhangCells == 0)
+        {
+            TestCell(Cell);
+            return !bFound;
+        }
+
+        const int32 Col = Cell % Grid.Columns;
+        const int32 Row = Cell / Grid.Columns;
+        for (int32 R = FMath::Max(0, Row - DiskOverhangCells); R <= FMath::Min(Grid.Rows - 1, Row + DiskOverhangCells); ++R)
+        {
+            for (int32 C = FMath::Max(0, Col - DiskOverhangCells); C <= FMath::Min(Grid.Columns - 1, Col + DiskOverhangCells); ++C)
+                TestCell(C + R * Grid.Columns);
+        }
+        return true;
+    });
+
+    return bFound;
+}
+
+void ADiskSpawner::GetDisksInRadius(const FVector& Center, float Radius, TArray<int32>& OutCells) const
+{
+    const int32 First = OutCells.Num();
+    Grid.CellsInRadius(FVector2D(Center), Radius, OutCells);
+
+    // The other layers' disks share those cells.
+    const int32 LastCell = OutCells.Num();
+    for (int32 i = First; i < LastCell; ++i)
     {
-        HitDisk->FreezeGreen();
+        for (int32 Index = OutCells[i] + Simulation.CellsPerLayer; Index < Simulation.Num(); Index += Simulation.CellsPerLayer)
+            OutCells.Add(Index);
     }
+
+    // The grid narrowed it down in XY; drop the disks that are too far above or below.
+    const double RadiusSq = FMath::Square(Radius);
+    for (int32 i = OutCells.Num() - 1; i >= First; --i)
+    {
+        if (FVector::DistSquared(GetDiskLocation(OutCells[i]), Center) > RadiusSq)
+            OutCells.RemoveAtSwap(i, 1, EAllowShrinking::No);
+    }
+}
+
+FVector ADiskSpawner::GetDiskLocation(int32 Index) const
+{
+    return FVector(CellPositions[Index], Simulation.ToWorldZ(Simulation.Heights[Index]));
+}
+
+bool ADiskSpawner::WasDiskRespawnedSince(int32 Index, double Time) const
+{
+    return Simulation.SpawnTimes.IsValidIndex(Index) && Simulation.SpawnTimes[Index] > Time;
 }
 
 /** Called by UI_WinScreen's "Play Infinite Mode" button via Blueprint. */
@@ -94,6 +501,10 @@ void ADiskSpawner::StartInfiniteMode()
     bInfiniteMode = true;
     bGameWon = false;
 
+    // Endless climbing needs the field to stream; clients follow through ReplicatedGridSize.
+    if (HasAuthority() && InfiniteModeLayers > GridLayers)
+        RelayoutGrid(GridColumns, GridRows, InfiniteModeLayers);
+
     if (WinScreenWidget && WinScreenWidget->IsInViewport())
         WinScreenWidget->RemoveFromParent();
 
@@ -114,94 +525,615 @@ void ADiskSpawner::SpawnAllDisks()
         return;
     }
 
-    const int32 Total = GridColumns * GridRows;
-    Disks.SetNum(Total);
+    GridLayers = FMath::Max(GridLayers, 1);
+    const int32 Total = GridColumns * GridRows * GridLayers;
+    Grid.Init(FVector2D(GetActorLocation()), GridColumns, GridRows, CellSize);
+    Simulation.Reset(Total, GridLayers);
+    Simulation.PlaceLayers(Simulation.ToLocalZ(GetActorLocation().Z));
+    CellPositions.SetNum(Total);
+    CacheDiskShape();
 
-    FActorSpawnParameters Params;
-    Params.Owner = this;
+    // Every disk's first speed comes from its own substream, so the grid is generated in bulk.
+    TArray<float> InitialSpeeds;
+    InitialSpeeds.SetNumUninitialized(Total);
+    FDiskRandom::GenerateSpeeds(Simulation.Config.Seed, 0, Simulation.SpawnCounts, MinSpeed, MaxSpeed, InitialSpeeds);
+
+    if (!bUseInstancedDisks)
+        Disks.Init(nullptr, Total);
+
+    for (int32 Index = 0; Index < Total; ++Index)
+        PlaceDisk(Index, InitialSpeeds[Index]);
+    PrevHeights = Simulation.Heights;
+
+    if (bUseInstancedDisks)
+    {
+        Disks.Reset();
+        SpawnDiskInstances();
+        return;
+    }
+
+    ResetSignificance();
+
+    // Spares for ResizeGrid, paid for here at level load rather than during play.
+    TopUpPool(PoolPrewarmCount);
+}
+
+void ADiskSpawner::PlaceDisk(int32 Index, float Speed)
+{
+    const int32 Cell = Simulation.CellOf(Index);
+    CellPositions[Index] = Grid.CellCenter(Cell % GridColumns, Cell / GridColumns);
+
+    // Above the highest player as of the last tick (or the spawner, before there is one), or
+    // at the top of the disk's layer band.
+    Simulation.Spawn(Index, Simulation.GetSpawnZ(Index, Simulation.ToLocalZ(GetActorLocation().Z)), Speed);
+
+    if (!bUseInstancedDisks)
+        Disks[Index] = AcquireDisk(Index);
+}
+
+void ADiskSpawner::ResizeGrid(int32 NewColumns, int32 NewRows)
+{
+    // Clients lay out their grid from ReplicatedGridSize; resizing one locally would leave its
+    // cells out of step with the server's net items.
+    if (!HasAuthority()) return;
+
+    RelayoutGrid(NewColumns, NewRows, GridLayers);
+}
+
+void ADiskSpawner::RelayoutGrid(int32 NewColumns, int32 NewRows, int32 NewLayers)
+{
+    LLM_SCOPE_BYTAG(StackOBot);
+
+    NewColumns = FMath::Max(1, NewColumns);
+    NewRows    = FMath::Max(1, NewRows);
+    NewLayers  = FMath::Max(1, NewLayers);
+    if (!DiskClass || (NewColumns == GridColumns && NewRows == GridRows && NewLayers == GridLayers)) return;
 
-    for (int32 Row = 0; Row < GridRows; ++Row)
+    // The grid is centred on the spawner, so align the old block in the middle of the new one.
+    const int32 ColShift = (NewColumns - GridColumns) / 2;
+    const int32 RowShift = (NewRows - GridRows) / 2;
+    const int32 OldCells = GridColumns * GridRows;
+    const int32 NewCells = NewColumns * NewRows;
+    const int32 NewTotal = NewCells * NewLayers;
+
+    // Scratch for this call only, so it comes off the thread's memory stack instead of the heap.
+    FMemMark Mark(FMemStack::Get());
+    TArray<int32, TMemStackAllocator<>> OldIndexOf;
+    OldIndexOf.Init(INDEX_NONE, NewTotal);
+    TArray<AFallingDisk*> NewDisks;
+    NewDisks.Init(nullptr, bUseInstancedDisks ? 0 : NewTotal);
+
+    for (int32 Layer = 0; Layer < FMath::Min(NewLayers, GridLayers); ++Layer)
     {
-        for (int32 Col = 0; Col < GridColumns; ++Col)
+        for (int32 Row = 0; Row < NewRows; ++Row)
         {
-            const int32 Index = Col + Row * GridColumns;
-            AFallingDisk* Disk = GetWorld()->SpawnActor<AFallingDisk>(
-                DiskClass, CellSpawnLocation(Col, Row), FRotator::ZeroRotator, Params);
-            if (Disk)
+            for (int32 Col = 0; Col < NewColumns; ++Col)
             {
-                Disk->Initialize(RandomSpeed());
-                Disks[Index] = Disk;
+                const int32 OldCol = Col - ColShift;
+                const int32 OldRow = Row - RowShift;
+                if (OldCol < 0 || OldCol >= GridColumns || OldRow < 0 || OldRow >= GridRows) continue;
+
+                const int32 Index = Col + Row * NewColumns + Layer * NewCells;
+                const int32 Old   = OldCol + OldRow * GridColumns + Layer * OldCells;
+                OldIndexOf[Index] = Old;
+
+                if (!bUseInstancedDisks)
+                {
+                    NewDisks[Index] = Disks[Old];
+                    Disks[Old] = nullptr;
+                }
             }
         }
     }
+
+    // Whatever is left belonged to cells or layers that fell off the grid.
+    for (AFallingDisk* Disk : Disks)
+    {
+        if (Disk) ReleaseDisk(Disk);
+    }
+
+    GridColumns = NewColumns;
+    GridRows    = NewRows;
+    GridLayers  = NewLayers;
+    Disks       = MoveTemp(NewDisks);
+
+    Grid.Init(FVector2D(GetActorLocation()), GridColumns, GridRows, CellSize);
+    Simulation.Remap(OldIndexOf, GridLayers);
+    CellPositions.SetNum(NewTotal);
+
+    for (int32 Index = 0; Index < NewTotal; ++Index)
+    {
+        if (OldIndexOf[Index] == INDEX_NONE)
+        {
+            PlaceDisk(Index, Simulation.RandomSpeed(Index));
+            continue;
+        }
+
+        // Survivors keep their height and state but snap to the new cell centre.
+        const int32 Cell = Simulation.CellOf(Index);
+        CellPositions[Index] = Grid.CellCenter(Cell % GridColumns, Cell / GridColumns);
+        if (AFallingDisk* Disk = bUseInstancedDisks ? nullptr : Disks[Index])
+        {
+            Disk->CellIndex = Index;
+            Disk->SetActorLocation(GetDiskLocation(Index));
+        }
+    }
+
+    PrevHeights = Simulation.Heights;   // Cells moved; nothing to blend from
+
+    // Survivors keep their tier; disks fresh from the pool start near (see AcquireDisk).
+    if (!bUseInstancedDisks)
+    {
+        const TBitArray<> OldNear = MoveTemp(NearDisks);
+        NearDisks.Init(true, NewTotal);
+        NearIndices.Reset();
+        for (int32 Index = 0; Index < NewTotal; ++Index)
+        {
+            const int32 Old = OldIndexOf[Index];
+            if (Old != INDEX_NONE && OldNear.IsValidIndex(Old))
+                NearDisks[Index] = OldNear[Old];
+            if (NearDisks[Index])
+                NearIndices.Add(Index);
+        }
+    }
+
+    if (bUseInstancedDisks)
+        SpawnDiskInstances();
+
+    if (HasAuthority())
+    {
+        ReplicatedGridSize = FIntVector(GridColumns, GridRows, GridLayers);
+        RebuildNetDisks();
+
+        // The replay has no resize op; close this recording and open one from the new field.
+        if (Replay.IsRecording())
+            StartReplayRecording();
+    }
+}
+
+AFallingDisk* ADiskSpawner::SpawnPooledDisk()
+{
+    FActorSpawnParameters Params;
+    Params.Owner = this;
+
+    AFallingDisk* Disk = GetWorld()->SpawnActor<AFallingDisk>(
+        DiskClass, GetActorLocation(), FRotator::ZeroRotator, Params);
+    if (Disk)
+    {
+        Disk->SetActorHiddenInGame(true);
+        Disk->SetActorEnableCollision(false);
+    }
+    return Disk;
+}
+
+AFallingDisk* ADiskSpawner::AcquireDisk(int32 Index)
+{
+    AFallingDisk* Disk = FreeDisks.Num() > 0 ? FreeDisks.Pop(EAllowShrinking::No) : SpawnPooledDisk();
+    if (!Disk) return nullptr;
+
+    Disk->CellIndex = Index;
+    Disk->bKnockbackOnHit = SimulationHz <= 0.f;   // Otherwise ApplySweptKnockback handles it
+    Disk->Respawn(GetDiskLocation(Index), Simulation.Speeds[Index]);
+    Disk->FlushVisualState();   // A pooled disk may still be drawn in the colour it was released with
+    Disk->SetActorHiddenInGame(false);
+    Disk->SetActorEnableCollision(true);
+    Disk->SetSignificant(true);   // UpdateDiskSignificance demotes it if no player is close
+    return Disk;
+}
+
+void ADiskSpawner::ReleaseDisk(AFallingDisk* Disk)
+{
+    Disk->SetActorHiddenInGame(true);
+    Disk->SetActorEnableCollision(false);
+    Disk->CellIndex = INDEX_NONE;
+    FreeDisks.Add(Disk);
+}
+
+void ADiskSpawner::TopUpPool(int32 Budget)
+{
+    if (!DiskClass) return;
+
+    DISKFIELD_PHASE_SCOPE(TopUpPool);
+
+    for (int32 i = 0; i < Budget && FreeDisks.Num() < PoolPrewarmCount; ++i)
+    {
+        AFallingDisk* Disk = SpawnPooledDisk();
+        if (!Disk) break;
+        FreeDisks.Add(Disk);
+    }
+}
+
+void ADiskSpawner::SpawnDiskInstances()
+{
+    // Borrow the mesh, scale and knockback tuning from BP_FallingDisk's defaults.
+    const AFallingDisk* DiskDefaults = DiskClass->GetDefaultObject<AFallingDisk>();
+    InstanceKnockbackForce = DiskDefaults->KnockbackForce;
+
+    FVector InstanceScale = FVector::OneVector;
+    if (DiskDefaults->DiskMesh)
+    {
+        DiskInstances->SetStaticMesh(DiskDefaults->DiskMesh->GetStaticMesh());
+        InstanceScale = DiskDefaults->DiskMesh->GetRelativeScale3D();
+    }
+    if (InstancedDiskMaterial)
+        DiskInstances->SetMaterial(0, InstancedDiskMaterial);
+
+    const int32 Total = Simulation.Num();
+    InstanceTransforms.SetNum(Total);
+    for (int32 i = 0; i < Total; ++i)
+        InstanceTransforms[i] = FTransform(FQuat::Identity, GetDiskLocation(i), InstanceScale);
+
+    DiskInstances->ClearInstances();
+    DiskInstances->AddInstances(InstanceTransforms, /*bShouldReturnIndices=*/false, /*bWorldSpace=*/true);
+    for (int32 i = 0; i < Total; ++i)
+        SetInstanceState(i);
+    FlushDiskStates();
+}
+
+void ADiskSpawner::CacheDiskShape()
+{
+    const AFallingDisk* DiskDefaults = DiskClass->GetDefaultObject<AFallingDisk>();
+    const UStaticMesh*  Mesh = DiskDefaults->DiskMesh ? DiskDefaults->DiskMesh->GetStaticMesh() : nullptr;
+    if (Mesh)   // Otherwise keep the header defaults
+    {
+        const FBoxSphereBounds Bounds = Mesh->GetBounds();
+        const FVector Scale = DiskDefaults->DiskMesh->GetRelativeScale3D();
+        DiskRadius        = FMath::Max(Bounds.BoxExtent.X * Scale.X, Bounds.BoxExtent.Y * Scale.Y);
+        DiskHalfHeight    = Bounds.BoxExtent.Z * Scale.Z;
+        DiskCenterOffsetZ = Bounds.Origin.Z * Scale.Z;
+    }
+
+    // RaycastDisks stops at the first cell with a hit, which is only right while each disk fits its cell.
+    DiskOverhangCells = FMath::Max(0, FMath::CeilToInt32((DiskRadius - CellSize * 0.5f) / CellSize));
+    if (DiskOverhangCells > 0)
+    {
+        UE_LOG(LogTemp, Warning,
+            TEXT("DiskSpawner: disks (radius %.0f) are wider than a %.0f UU cell; shots also test %d ring(s) of neighbouring cells"),
+            DiskRadius, CellSize, DiskOverhangCells);
+    }
 }
 
-FVector ADiskSpawner::CellSpawnLocation(int32 Col, int32 Row) const
+bool ADiskSpawner::RayHitsDisk(int32 Index, const FVector& Start, const FVector& Dir, float& OutTime) const
 {
-    const float GridWidth = GridColumns * CellSize;
-    const float GridDepth = GridRows * CellSize;
+    // Vertical cylinder: clip the segment against the disk's Z slab, then its XY circle.
+    const double CenterZ = Simulation.ToWorldZ(GetRenderHeight(Index)) + DiskCenterOffsetZ;   // Where the player sees it
+    double TEnter = 0.0;
+    double TExit  = 1.0;
+
+    if (FMath::Abs(Dir.Z) < UE_KINDA_SMALL_NUMBER)
+    {
+        if (FMath::Abs(Start.Z - CenterZ) > DiskHalfHeight) return false;
+    }
+    else
+    {
+        double T0 = (CenterZ - DiskHalfHeight - Start.Z) / Dir.Z;
+        double T1 = (CenterZ + DiskHalfHeight - Start.Z) / Dir.Z;
+        if (T0 > T1) Swap(T0, T1);
+        TEnter = FMath::Max(TEnter, T0);
+        TExit  = FMath::Min(TExit, T1);
+        if (TEnter > TExit) return false;
+    }
+
+    const FVector2D S = FVector2D(Start) - CellPositions[Index];
+    const FVector2D D = FVector2D(Dir);
+    const double A = D.SizeSquared();
+    const double C = S.SizeSquared() - FMath::Square(DiskRadius);
 
-    const float OffsetX = (Col + 0.5f) * CellSize - GridWidth * 0.5f;
-    const float OffsetY = (Row + 0.5f) * CellSize - GridDepth * 0.5f;
+    if (A < UE_KINDA_SMALL_NUMBER)
+    {
+        if (C > 0.0) return false;   // Vertical ray outside the circle
+    }
+    else
+    {
+        const double B = 2.0 * FVector2D::DotProduct(S, D);
+        const double Discriminant = B * B - 4.0 * A * C;
+        if (Discriminant < 0.0) return false;
+
+        const double Root = FMath::Sqrt(Discriminant);
+        TEnter = FMath::Max(TEnter, (-B - Root) / (2.0 * A));
+        TExit  = FMath::Min(TExit, (-B + Root) / (2.0 * A));
+        if (TEnter > TExit) return false;
+    }
+
+    OutTime = static_cast<float>(TEnter);
+    return true;
+}
 
-    const FVector Origin = GetActorLocation();
+void ADiskSpawner::SyncSimulationConfig()
+{
+    // Copied every tick so tweaks made while playing in the editor take effect. The seed is
+    // fixed at BeginPlay.
+    FDiskFieldConfig& Config = Simulation.Config;
+    Config.GroundZ            = GroundZ;
+    Config.RespawnBelowOffset = RespawnBelowOffset;
+    Config.SpawnHeightOffset  = SpawnHeightOffset;
+    Config.MinSpeed           = MinSpeed;
+    Config.MaxSpeed           = MaxSpeed;
 
-    // Spawn above the player's current height, not the spawner's fixed height.
-    const float BaseZ = CachedPlayer
-        ? CachedPlayer->GetActorLocation().Z + SpawnHeightOffset
-        : Origin.Z + SpawnHeightOffset;
+    // Every fixed step of a frame adds to Events before ApplySimulationEvents drains them.
+    // Takes effect at the next Reset or resize.
+    Simulation.TicksPerDrain = MaxStepsPerFrame;
 
-    return FVector(Origin.X + OffsetX, Origin.Y + OffsetY, BaseZ);
+    FDiskDifficultyConfig& Tuning = Simulation.Difficulty.Config;
+    Tuning.bEnabled             = bAutoDifficulty;
+    Tuning.TargetClimbRate      = TargetClimbRate;
+    Tuning.TargetAccuracy       = TargetAccuracy;
+    Tuning.TargetFallsPerMinute = TargetFallsPerMinute;
+    Tuning.MinScale             = MinDifficultyScale;
+    Tuning.MaxScale             = MaxDifficultyScale;
 }
 
-float ADiskSpawner::RandomSpeed() const
+void ADiskSpawner::ApplySimulationEvents()
 {
-    return FMath::RandRange(MinSpeed, MaxSpeed);
+    DISKFIELD_PHASE_SCOPE(ApplyEvents);
+
+    if (Simulation.Events.Num() == 0) return;
+
+    const bool bReplicate = HasAuthority() && GetNetMode() != NM_Standalone;
+
+    int32 NumRespawns = 0;
+    for (const FDiskEvent& Event : Simulation.Events)
+    {
+        NumRespawns += Event.Type == EDiskEvent::Respawned || Event.Type == EDiskEvent::Recycled;
+        ApplyDiskEvent(Event);
+        if (bReplicate)
+            WriteNetDisk(Event.Index);
+    }
+    DISKFIELD_COUNT(Respawns, NumRespawns);
+    Replay.RecordEvents(Simulation.Events);
+    DISKFIELD_COUNT(NetUpdates, bReplicate ? Simulation.Events.Num() : 0);
+
+    if (UDiskFieldSubsystem* Subsystem = GetWorld()->GetSubsystem<UDiskFieldSubsystem>())
+        Subsystem->OnDiskStateChanged.Broadcast(Simulation.Events);
+
+    FlushDiskStates();
+    Simulation.Events.Reset();
 }
 
-void ADiskSpawner::CheckGroundHits()
+void ADiskSpawner::ApplyDiskEvent(const FDiskEvent& Event)
 {
-    const float PlayerZ = CachedPlayer ? CachedPlayer->GetActorLocation().Z : 0.f;
+    const int32 Index = Event.Index;
+
+    // Respawns teleport and freezes stop dead; neither should be blended from the old height.
+    if (PrevHeights.IsValidIndex(Index))
+        PrevHeights[Index] = Simulation.Heights[Index];
 
+    if (bUseInstancedDisks)
+    {
+        // A respawned instance stays Falling, so only its transform changes (in PushDiskTransforms).
+        if (Event.Type != EDiskEvent::Respawned)
+            SetInstanceState(Index);
+        return;
+    }
+
+    AFallingDisk* Disk = Disks[Index];
+    if (!Disk) return;
+
+    switch (Event.Type)
+    {
+    case EDiskEvent::Respawned:
+    case EDiskEvent::Recycled:    Disk->Respawn(GetDiskLocation(Index), Simulation.Speeds[Index]); break;
+    case EDiskEvent::FrozenRed:   Disk->FreezeRed();      break;
+    case EDiskEvent::FrozenGreen: Disk->FreezeGreen();    break;
+    case EDiskEvent::Promoted:    Disk->PromoteToGreen(); break;
+    case EDiskEvent::Unfrozen:    Disk->Unfreeze();       break;
+    }
+
+    // A respawn leaves a falling disk falling: nothing to redraw.
+    if (Event.Type != EDiskEvent::Respawned)
+        PendingStateDisks.Add(Index);
+}
+
+void ADiskSpawner::SetInstanceState(int32 Index)
+{
+    // Replaces AFallingDisk::ApplyMaterial: the shared material picks the colour from this value.
+    DiskInstances->SetCustomDataValue(Index, 0,
+        static_cast<float>(Simulation.States[Index]), /*bMarkRenderStateDirty=*/false);
+    PendingStateDisks.Add(Index);
+}
+
+void ADiskSpawner::FlushDiskStates()
+{
+    if (PendingStateDisks.Num() == 0) return;
+
+    int32 NumUpdates = 0;
+    if (bUseInstancedDisks)
+    {
+        // The custom data was written in place; one dirty mark re-uploads it with the transforms.
+        DiskInstances->MarkRenderStateDirty();
+        NumUpdates = PendingStateDisks.Num();
+    }
+    else
+    {
+        // A disk can change twice in one pass (frozen, then promoted); only the last state is sent.
+        for (const int32 Index : PendingStateDisks)
+        {
+            if (AFallingDisk* Disk = Disks.IsValidIndex(Index) ? Disks[Index] : nullptr)
+                NumUpdates += Disk->FlushVisualState();
+        }
+    }
+    DISKFIELD_COUNT(StateUpdates, NumUpdates);
+    PendingStateDisks.Reset();
+}
+
+void ADiskSpawner::PushDiskTransforms()
+{
+    DISKFIELD_PHASE_SCOPE(PushTransforms);
+
+    if (bUseInstancedDisks)
+    {
+        // One batched update for the whole field instead of a move per actor. Filling the
+        // transforms is plain data, so it is split the same way as the simulation tick.
+        const int32 NumDisks  = Simulation.Num();
+        const int32 ChunkSize = FMath::Max(Simulation.DisksPerTask, 1);
+        ParallelFor(FMath::DivideAndRoundUp(NumDisks, ChunkSize), [this, NumDisks, ChunkSize](int32 Chunk)
+        {
+            const int32 End = FMath::Min((Chunk + 1) * ChunkSize, NumDisks);
+            for (int32 i = Chunk * ChunkSize; i < End; ++i)
+                InstanceTransforms[i].SetTranslation(FVector(CellPositions[i], Simulation.ToWorldZ(GetRenderHeight(i))));
+        });
+
+        DiskInstances->BatchUpdateInstancesTransforms(0, InstanceTransforms,
+            /*bWorldSpace=*/true, /*bMarkRenderStateDirty=*/true, /*bTeleport=*/false);
+        return;
+    }
+
+    // Frozen disks never move, so only falling ones need a new transform. Actor moves touch
+    // UObjects and physics, so they stay on the game thread.
+    const bool   bTiered  = FarUpdateInterval > 1 && NearDisks.Num() == Disks.Num();
+    const uint32 Interval = static_cast<uint32>(FMath::Max(FarUpdateInterval, 1));
+    const uint32 FarPhase = SignificanceFrame % Interval;
     for (int32 i = 0; i < Disks.Num(); ++i)
     {
         AFallingDisk* Disk = Disks[i];
-        if (!Disk || Disk->DiskState != EDiskState::Falling) continue;
+        if (!Disk || Simulation.States[i] != EDiskState::Falling) continue;
+
+        // A far disk moves on one frame in FarUpdateInterval; its cell picks which one.
+        if (bTiered && !NearDisks[i] && static_cast<uint32>(i) % Interval != FarPhase) continue;
+
+        Disk->SetActorLocation(FVector(CellPositions[i], Simulation.ToWorldZ(GetRenderHeight(i))));
+    }
+}
+
+void ADiskSpawner::UpdateDiskSignificance()
+{
+    DISKFIELD_PHASE_SCOPE(Significance);
 
-        const float DiskZ = Disk->GetActorLocation().Z;
+    ++SignificanceFrame;
+    if (bUseInstancedDisks || NearDisks.Num() != Disks.Num()) return;
 
-        // Respawn if the disk hit the floor OR drifted too far below the player.
-        if (DiskZ < GroundZ || DiskZ < (PlayerZ - RespawnBelowOffset))
+    // Clients only know their own pawn; the server tracks everyone in Players.
+    SignificanceCells.Reset();
+    if (NearDiskRadius <= 0.f)
+    {
+        for (int32 Cell = 0; Cell < Grid.Num(); ++Cell)
+            SignificanceCells.Add(Cell);
+    }
+    else
+    {
+        for (const TWeakObjectPtr<ACharacter>& PlayerPtr : Players)
         {
-            const int32 Col = i % GridColumns;
-            const int32 Row = i / GridColumns;
-            Disk->Respawn(CellSpawnLocation(Col, Row), RandomSpeed());
+            if (const ACharacter* Player = PlayerPtr.Get())
+                Grid.CellsInRadius(FVector2D(Player->GetActorLocation()), NearDiskRadius, SignificanceCells);
         }
+        if (CachedPlayer)
+            Grid.CellsInRadius(FVector2D(CachedPlayer->GetActorLocation()), NearDiskRadius, SignificanceCells);
     }
+
+    // Promote the newly near disks, every layer of each cell, skipping cells where players' circles overlap.
+    NextNearDisks.Init(false, Disks.Num());
+    NextNearIndices.Reset();
+    for (const int32 Cell : SignificanceCells)
+    {
+        if (NextNearDisks[Cell]) continue;
+
+        for (int32 Index = Cell; Index < Disks.Num(); Index += Simulation.CellsPerLayer)
+        {
+            NextNearDisks[Index] = true;
+            NextNearIndices.Add(Index);
+            if (!NearDisks[Index])
+                SetDiskSignificant(Index, true);
+        }
+    }
+
+    for (const int32 Index : NearIndices)
+    {
+        if (!NextNearDisks[Index])
+            SetDiskSignificant(Index, false);
+    }
+
+    Swap(NearDisks, NextNearDisks);
+    Swap(NearIndices, NextNearIndices);
+}
+
+void ADiskSpawner::ResetSignificance()
+{
+    // Freshly acquired disk actors are all at full fidelity; the next update demotes the far ones.
+    const int32 NumDisks = Disks.Num();
+    NearDisks.Init(true, NumDisks);
+    NearIndices.Reset(NumDisks);
+    for (int32 i = 0; i < NumDisks; ++i)
+        NearIndices.Add(i);
+}
+
+void ADiskSpawner::SetDiskSignificant(int32 Index, bool bNear)
+{
+    if (AFallingDisk* Disk = Disks[Index])
+        Disk->SetSignificant(bNear);
+}
+
+float ADiskSpawner::GetNetTime() const
+{
+    // Server and clients agree on the game state's clock to within the ping estimate.
+    const AGameStateBase* GameState = GetWorld()->GetGameState();
+    return static_cast<float>(GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds());
 }
 
-void ADiskSpawner::CheckRedPromotion()
+void ADiskSpawner::WriteNetDisk(int32 Index)
 {
-    if (!RedDisk || !CachedPlayer) return;
-    if (RedDisk->DiskState != EDiskState::FrozenRed) return;
+    // Height and speed at this instant; clients extrapolate the fall from AnchorTime.
+    FDiskNetItem& Item = NetDisks.Items[Index];
+    Item.Cell       = Index;
+    Item.BaseZ      = static_cast<int32>(FMath::RoundToInt64(Simulation.ToWorldZ(Simulation.Heights[Index])));
+    Item.SpeedQ     = static_cast<uint16>(FMath::Clamp(
+        FMath::RoundToInt32(Simulation.Speeds[Index] / FDiskNetItem::SpeedQuantum), 0, static_cast<int32>(MAX_uint16)));
+    Item.State      = Simulation.States[Index];
+    Item.AnchorTime = GetNetTime();
+    NetDisks.MarkItemDirty(Item);
+}
 
-    if (CachedPlayer->GetActorLocation().Z > RedDisk->GetActorLocation().Z)
+void ADiskSpawner::RebuildNetDisks()
+{
+    if (GetNetMode() == NM_Standalone) return;
+
+    NetDisks.Items.Reset();
+    NetDisks.Items.SetNum(Simulation.Num());
+    for (int32 i = 0; i < Simulation.Num(); ++i)
+        WriteNetDisk(i);
+    NetDisks.MarkArrayDirty();
+}
+
+void ADiskSpawner::ApplyAllNetDisks()
+{
+    for (const FDiskNetItem& Item : NetDisks.Items)
+        ApplyNetDisk(Item);
+}
+
+void ADiskSpawner::OnRep_GridSize()
+{
+    // Before BeginPlay the first SpawnAllDisks just picks up the new size.
+    if (!HasActorBegunPlay())
     {
-        RedDisk->PromoteToGreen();
-        RedDisk = nullptr;
+        GridColumns = ReplicatedGridSize.X;
+        GridRows    = ReplicatedGridSize.Y;
+        GridLayers  = ReplicatedGridSize.Z;
+        return;
     }
+
+    RelayoutGrid(ReplicatedGridSize.X, ReplicatedGridSize.Y, ReplicatedGridSize.Z);
+    ApplyAllNetDisks();
 }
 
-void ADiskSpawner::CheckGreenUnfreeze()
+void ADiskSpawner::GatherPlayers(TArray<FDiskPlayer, TInlineAllocator<32>>& OutPlayers)
 {
-    if (!CachedPlayer) return;
-    const float PlayerZ = CachedPlayer->GetActorLocation().Z;
+    // Everyone with a player controller counts; other characters join via RegisterPlayer.
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        RegisterPlayer(PC ? Cast<ACharacter>(PC->GetPawn()) : nullptr);
+    }
 
-    for (AFallingDisk* Disk : Disks)
+    for (int32 Slot = 0; Slot < Players.Num(); ++Slot)
     {
-        if (!Disk || Disk->DiskState != EDiskState::FrozenGreen) continue;
-        if (PlayerZ < Disk->GetActorLocation().Z)
-            Disk->Unfreeze();
+        const ACharacter* Player = Players[Slot].Get();
+        if (!Player)
+        {
+            // Destroyed without unregistering: free its red disk and the slot once.
+            if (!Players[Slot].IsExplicitlyNull())
+                ReleasePlayerSlot(Slot);
+            continue;
+        }
+        OutPlayers.Add({ Slot, FDiskReplay::QuantizeHeight(Simulation.ToLocalZ(Player->GetActorLocation().Z)) });
     }
 }
 
@@ -217,10 +1149,35 @@ void ADiskSpawner::CheckWinCondition(float PlayerZ)
 
 void ADiskSpawner::UpdateHUD(float PlayerZ)
 {
+    DISKFIELD_PHASE_SCOPE(UpdateHUD);
+
     if (HUDWidget)
         HUDWidget->UpdateValues(PlayerZ, HighestZ);
 }
 
+void ADiskSpawner::UpdateStats()
+{
+    const int32 NumFalling = Simulation.Num() - Simulation.NumGreen - Simulation.NumRed;
+
+    SET_DWORD_STAT(STAT_DiskField_NumFalling, NumFalling);
+    SET_DWORD_STAT(STAT_DiskField_NumRed,     Simulation.NumRed);
+    SET_DWORD_STAT(STAT_DiskField_NumGreen,   Simulation.NumGreen);
+    SET_DWORD_STAT(STAT_DiskField_NumNear,    NearIndices.Num());
+    TRACE_COUNTER_SET(DiskField_NumFalling, NumFalling);
+    TRACE_COUNTER_SET(DiskField_NumRed,     Simulation.NumRed);
+    TRACE_COUNTER_SET(DiskField_NumGreen,   Simulation.NumGreen);
+    TRACE_COUNTER_SET(DiskField_NumNear,    NearIndices.Num());
+
+    const FDiskDifficulty& Difficulty = Simulation.Difficulty;
+    SET_FLOAT_STAT(STAT_DiskField_DifficultyScale, Difficulty.GetTargetScale());
+    SET_FLOAT_STAT(STAT_DiskField_ClimbRate,       Difficulty.GetClimbRate());
+    SET_FLOAT_STAT(STAT_DiskField_Accuracy,        Difficulty.GetAccuracy());
+    SET_FLOAT_STAT(STAT_DiskField_FallRate,        Difficulty.GetFallsPerMinute());
+    TRACE_COUNTER_SET(DiskField_DifficultyScale, Difficulty.GetTargetScale());
+
+    FDiskFieldProfiler::Tick(GetWorld()->GetRealTimeSeconds());
+}
+
 void ADiskSpawner::ShowWinScreen()
 {
     if (!WinScreenWidget) return;
@@ -232,4 +1189,19 @@ void ADiskSpawner::ShowWinScreen()
         PC->SetInputMode(FInputModeUIOnly());
         PC->SetShowMouseCursor(true);
     }
+}
+
+void ADiskSpawner::OnInstancedDiskHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
+    UPrimitiveComponent* OtherComp, FVector NormalImpulse,
+    const FHitResult& Hit)
+{
+    // When the character sweeps into us the hit arrives reversed, so our instance is MyItem.
+    const int32 Index = Hit.GetComponent() == DiskInstances.Get() ? Hit.Item : Hit.MyItem;
+
+    // Only falling disks knock the player back, and only here when knockback isn't swept per step.
+    if (SimulationHz > 0.f) return;
+    if (!Simulation.States.IsValidIndex(Index)) return;
+    if (Simulation.States[Index] != EDiskState::Falling) return;
+
+    AFallingDisk::ApplyKnockback(Cast<ACharacter>(OtherActor), GetDiskLocation(Index), InstanceKnockbackForce);
 }
\ No newline at end of file
@@ -3,9 +3,22 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "FallingDisk.h"
+#include "DiskSimulation.h"
+#include "DiskGrid.h"
+#include "DiskFieldReplication.h"
+#include "DiskFieldReplay.h"
 #include "DiskSpawner.generated.h"
 
 class UPlayerHUDWidget;   // forward declare �C defined in Phase 3b
+class UInstancedStaticMeshComponent;
+
+/** Result of ADiskSpawner::RaycastDisks. */
+struct FDiskRayHit
+{
+    int32   Cell = INDEX_NONE;
+    float   Time = 0.f;                         // Fraction along Start -> End
+    FVector ImpactPoint = FVector::ZeroVector;
+};
 
 UCLASS()
 class STACKOBOT_API ADiskSpawner : public AActor
@@ -16,10 +29,13 @@ public:
     ADiskSpawner();
 
 protected:
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     virtual void Tick(float DeltaTime) override;
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
     // ���� Grid configuration ��������������������������������������������������������������������������������������������������������������
     UPROPERTY(EditAnywhere, Category = "Spawner|Grid")
@@ -28,6 +44,30 @@ public:
     UPROPERTY(EditAnywhere, Category = "Spawner|Grid")
     int32 GridRows = 4;
 
+    /**
+     * Stacked copies of the grid, each respawning its disks at the top of its own height band.
+     * More than one streams the field: bands the players climbed away from are recycled above
+     * them, so the disk count stays GridColumns * GridRows * GridLayers at any height.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Grid", meta = (ClampMin = "1"))
+    int32 GridLayers = 1;
+
+    /** Height of each layer's band when GridLayers > 1. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Grid", meta = (ClampMin = "100"))
+    float LayerSpacing = 1000.f;
+
+    /** GridLayers switched to by StartInfiniteMode, for endless climbing. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Grid", meta = (ClampMin = "1"))
+    int32 InfiniteModeLayers = 4;
+
+    /** Spare disks spawned hidden at level load so ResizeGrid can grow the field without spawning. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Pool", meta = (ClampMin = "0"))
+    int32 PoolPrewarmCount = 0;
+
+    /** The pool is topped back up to PoolPrewarmCount at no more than this many spawns per frame. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Pool", meta = (ClampMin = "1"))
+    int32 MaxPoolSpawnsPerFrame = 8;
+
     /** Width and depth of each grid cell in Unreal Units (1 UU = 1 cm). */
     UPROPERTY(EditAnywhere, Category = "Spawner|Grid")
     float CellSize = 350.f;
@@ -51,6 +91,85 @@ public:
     UPROPERTY(EditAnywhere, Category = "Spawner|Speed")
     float MaxSpeed = 500.f;
 
+    /**
+     * Seed for the disk speed stream. 0 picks a fresh seed each session; the seed in use is
+     * logged at BeginPlay so a bad session can be reproduced by entering it here.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Speed")
+    int32 Seed = 0;
+
+    // ── Fixed timestep ─────────────────────────────────────────────────────────
+    /**
+     * Steps per second of the disk field, whatever the frame rate; rendering interpolates between
+     * the last two steps and knockback is swept per step. 0 steps once per frame by DeltaTime
+     * and leaves knockback to the physics hit callbacks.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Simulation", meta = (ClampMin = "0", ClampMax = "1000"))
+    float SimulationHz = 60.f;
+
+    /** Most steps run in one frame. After a longer hitch the field loses the surplus time instead of stalling the next frames catching up. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Simulation", meta = (ClampMin = "1"))
+    int32 MaxStepsPerFrame = 4;
+
+    // ── Significance ───────────────────────────────────────────────────────────
+    /**
+     * Disk actors within this XY distance of a player keep physics collision, hit events and a
+     * move every frame. Farther ones go query-only (the laser and character sweeps still find
+     * them) and move every FarUpdateInterval frames. 0 keeps every disk near. Actor mode only.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Significance", meta = (ClampMin = "0"))
+    float NearDiskRadius = 2000.f;
+
+    /** Frames between moves of a far disk, staggered by cell so each frame moves a share of them. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Significance", meta = (ClampMin = "1"))
+    int32 FarUpdateInterval = 4;
+
+    // ── Difficulty ─────────────────────────────────────────────────────────────
+    /**
+     * Tune the disk speeds to the players as they play: disks get faster while the players
+     * climb, hit and stay up better than the targets below, and slower while they fall short.
+     * Each cell's speeds are scaled between MinDifficultyScale and MaxDifficultyScale. Server only.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty")
+    bool bAutoDifficulty = false;
+
+    /** Height the players should gain per second, averaged over about a minute. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty", meta = (ClampMin = "0"))
+    float TargetClimbRate = 60.f;
+
+    /** Share of the last shots that should freeze a disk. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty", meta = (ClampMin = "0", ClampMax = "1"))
+    float TargetAccuracy = 0.5f;
+
+    /** Drops of more than a few metres below a player's last peak, per minute. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty", meta = (ClampMin = "0"))
+    float TargetFallsPerMinute = 2.f;
+
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty", meta = (ClampMin = "0.1"))
+    float MinDifficultyScale = 0.5f;
+
+    UPROPERTY(EditAnywhere, Category = "Spawner|Difficulty", meta = (ClampMin = "0.1"))
+    float MaxDifficultyScale = 2.f;
+
+    // ── Replay ─────────────────────────────────────────────────────────────────
+    /**
+     * Record the session from BeginPlay to Saved/Replays/ for DiskFieldReplay. Also toggled at
+     * runtime with StackOBot.Replay.Start / StackOBot.Replay.Stop. Server only.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Replay")
+    bool bRecordReplay = false;
+
+    /** Recording buffer, allocated when recording starts; inputs beyond it are dropped. */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Replay", meta = (ClampMin = "16"))
+    int32 ReplayCapacityKB = 1024;
+
+    /**
+     * Also record every disk event so DiskFieldReplay can check the replay reproduces the
+     * session. Costs two to three bytes per respawn, which dominates the file on large grids.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Replay")
+    bool bReplayRecordEvents = false;
+
     // ���� Win condition ������������������������������������������������������������������������������������������������������������������������
     /** Player wins when their Z position exceeds this value. */
     UPROPERTY(EditAnywhere, Category = "Spawner|Win")
@@ -69,21 +188,136 @@ public:
     UPROPERTY(EditDefaultsOnly, Category = "Spawner")
     TSubclassOf<AFallingDisk> DiskClass;
 
+    // ── Instanced rendering ──────────────────────────────────────────────────────
+    /**
+     * Draw every disk as one instance of DiskInstances instead of spawning an AFallingDisk per cell.
+     * The mesh and knockback force still come from DiskClass's defaults.
+     */
+    UPROPERTY(EditAnywhere, Category = "Spawner|Instancing")
+    bool bUseInstancedDisks = false;
+
+    /** Shared disk material; reads PerInstanceCustomData[0] (0 = Falling, 1 = Red, 2 = Green). */
+    UPROPERTY(EditDefaultsOnly, Category = "Spawner|Instancing")
+    TObjectPtr<UMaterialInterface> InstancedDiskMaterial;
+
+    /** Holds one instance per disk (instance index == disk index) when bUseInstancedDisks is set. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    TObjectPtr<UInstancedStaticMeshComponent> DiskInstances;
+
     // ���� Public API ������������������������������������������������������������������������������������������������������������������������������
-    /** Called by UShootingComponent when its laser hits a disk. */
+    /** Called by UShootingComponent when its laser hits a disk. Server only. */
     void NotifyDiskHit(AFallingDisk* HitDisk, ACharacter* Player);
 
-    /** Called by UI_WinScreen's "Play Infinite Mode" button. Disables win check and resumes play. */
+    /** Same as NotifyDiskHit, addressed by grid cell (works in both rendering modes). Server only. */
+    void NotifyCellHit(int32 Index, ACharacter* Player);
+
+    /** Called by UShootingComponent when its laser hits no disk; counts against the players' accuracy for bAutoDifficulty. Server only. */
+    void NotifyShotMissed(ACharacter* Player);
+
+    /**
+     * Track Player's height in the rules and give them a slot (and so their own red disk).
+     * Returns the slot; registering twice returns the same one.
+     */
+    int32 RegisterPlayer(ACharacter* Player);
+
+    /** Stop tracking Player; their red disk resumes falling and the slot is reused. */
+    void UnregisterPlayer(ACharacter* Player);
+
+    /** Client side of the replicated field: mirror one server disk onto the local simulation. */
+    void ApplyNetDisk(const FDiskNetItem& Item);
+
+    /** Grid cell of the disk a trace hit (actor or instance), or INDEX_NONE if it was not a disk. */
+    int32 GetDiskCellFromHit(const FHitResult& Hit) const;
+
+    /**
+     * Nearest disk on the segment Start -> End, found by walking only the grid cells it crosses
+     * and testing each cell's disk cylinder. Does not touch the physics scene.
+     */
+    bool RaycastDisks(const FVector& Start, const FVector& End, FDiskRayHit& OutHit) const;
+
+    /** Append every disk whose centre lies within Radius of Center, visiting only nearby cells. */
+    void GetDisksInRadius(const FVector& Center, float Radius, TArray<int32>& OutCells) const;
+
+    /** Current world location of the disk in grid cell Index. */
+    FVector GetDiskLocation(int32 Index) const;
+
+    /** Rules state of the disk in grid cell Index. */
+    EDiskState GetDiskState(int32 Index) const { return Simulation.States[Index]; }
+
+    /** Simulation clock, for stamping work that completes later (e.g. an async shot). */
+    double GetSimulationTime() const { return Simulation.SimTime; }
+
+    /** True if the disk in cell Index respawned after simulation time Time. */
+    bool WasDiskRespawnedSince(int32 Index, double Time) const;
+
+    /** Shots that froze a disk, red or green, since BeginPlay; the total behind the "Hits / s" stat. */
+    int32 GetNumHits() const { return NumHits; }
+
+    /** Called by UI_WinScreen's "Play Infinite Mode" button. Disables win check, streams InfiniteModeLayers layers and resumes play. */
     UFUNCTION(BlueprintCallable, Category = "Spawner")
     void StartInfiniteMode();
 
+    /**
+     * Change the grid size at runtime. The overlapping block of cells keeps its disks and their
+     * state; removed cells return their disks to the pool and new cells take theirs from it.
+     * Server only; clients follow through ReplicatedGridSize.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Spawner")
+    void ResizeGrid(int32 NewColumns, int32 NewRows);
+
+    /** Start recording from the current disk state (restarting an active recording). */
+    void StartReplayRecording();
+
+    /** Write the active recording to Saved/Replays/ and stop. */
+    void StopReplayRecording();
+
+    /** Seed actually driving this session's disk speeds (Seed, or the one picked when Seed is 0). */
+    UFUNCTION(BlueprintPure, Category = "Spawner")
+    int32 GetActiveSeed() const { return static_cast<int32>(Simulation.Config.Seed); }
+
 private:
     TArray<AFallingDisk*> Disks;
-    AFallingDisk* RedDisk = nullptr;
+    TArray<AFallingDisk*> FreeDisks;     // Hidden, collision-less disks waiting for a cell
+
+    // Authoritative per-disk height/speed/state and the game rules; the actors above only mirror it.
+    FDiskSimulation   Simulation;
+    FDiskGrid         Grid;          // Cell layout used for spawning and the grid queries
+    TArray<FVector2D> CellPositions; // World XY of each disk's cell centre, cached at spawn
+    TArray<FTransform> InstanceTransforms;   // Scratch buffer for the batched instance update
+    TArray<int32>      PendingStateDisks;    // Disks whose colour changed this event pass
+    FDiskReplayRecorder Replay;              // Inputs fed to Simulation, while recording
+    TArray<float> PrevHeights;               // Heights before the last fixed step, for interpolation and sweeps
+    TArray<int32> KnockbackCells;            // Scratch for ApplySweptKnockback
+    float StepAccumulator = 0.f;             // Frame time not yet simulated
+    float RenderAlpha     = 1.f;             // Blend from PrevHeights to the current heights when drawing
+    float InstanceKnockbackForce = 0.f;      // DiskClass's KnockbackForce, used in instanced mode
+    TBitArray<>   NearDisks;                 // Per disk: the actor is at full fidelity
+    TBitArray<>   NextNearDisks;             // Scratch for UpdateDiskSignificance
+    TArray<int32> NearIndices;               // Set bits of NearDisks, so demotion only visits those
+    TArray<int32> NextNearIndices;
+    TArray<int32> SignificanceCells;         // Scratch: grid cells near a player
+    uint32        SignificanceFrame = 0;     // Picks which far disks move this frame
+    int32         NumHits           = 0;     // Successful HitDisk calls, for GetNumHits
+
+    // Disk cylinder for the grid queries, measured from DiskClass's mesh bounds at spawn
+    float DiskRadius        = 150.f;
+    float DiskHalfHeight    = 10.f;
+    float DiskCenterOffsetZ = 0.f;
+    int32 DiskOverhangCells = 0;     // Rings of neighbouring cells a disk reaches into; 0 when it fits its cell
 
     // UPROPERTY keeps these from being garbage-collected mid-session
     UPROPERTY()
-    TObjectPtr<ACharacter> CachedPlayer;
+    TObjectPtr<ACharacter> CachedPlayer;   // Local player, for the HUD and win check
+
+    // Players the rules react to; the array index is the player's slot in the simulation.
+    TArray<TWeakObjectPtr<ACharacter>> Players;
+
+    // Server -> client disk state, one item per cell, re-sent only when a disk changes state.
+    UPROPERTY(Replicated)
+    FDiskNetArray NetDisks;
+
+    UPROPERTY(ReplicatedUsing = OnRep_GridSize)
+    FIntVector ReplicatedGridSize = FIntVector::ZeroValue;   // Columns, rows, layers
 
     UPROPERTY()
     TObjectPtr<UPlayerHUDWidget> HUDWidget;
@@ -98,13 +332,73 @@ private:
     float HighestZ = 0.f;   // Highest height gained above SpawnZ this session
 
     void    SpawnAllDisks();
-    FVector CellSpawnLocation(int32 Col, int32 Row) const;
-    float   RandomSpeed() const;
+    void    PlaceDisk(int32 Index, float Speed);
+
+    /** ResizeGrid with a layer count; surviving layers keep their disks like surviving cells. */
+    void    RelayoutGrid(int32 NewColumns, int32 NewRows, int32 NewLayers);
+
+    // Actor pool (unused in instanced mode)
+    AFallingDisk* SpawnPooledDisk();
+    AFallingDisk* AcquireDisk(int32 Index);
+    void          ReleaseDisk(AFallingDisk* Disk);
+    void          TopUpPool(int32 Budget);
+
+    void    SpawnDiskInstances();
+    void    CacheDiskShape();
+    bool    RayHitsDisk(int32 Index, const FVector& Start, const FVector& Dir, float& OutTime) const;
+
+    /** Run the frame's fixed steps (or one variable step) of the rules, or of the fall on clients. */
+    void    StepSimulation(float DeltaTime);
+
+    /** Knock back airborne players whose head a falling disk's underside passed this step. */
+    void    ApplySweptKnockback();
+
+    /** Height the disk in cell Index is drawn (and shot) at: between the last two steps. */
+    float   GetRenderHeight(int32 Index) const
+    {
+        const float Z = Simulation.Heights[Index];
+        return RenderAlpha >= 1.f ? Z : FMath::Lerp(PrevHeights[Index], Z, RenderAlpha);
+    }
+
+    // Mirror FDiskSimulation's rule events onto the disk actors or instance custom data.
+    void    SyncSimulationConfig();
+    void    ApplySimulationEvents();
+    void    ApplyDiskEvent(const FDiskEvent& Event);
+    void    SetInstanceState(int32 Index);
+
+    /** Send the event pass's colour changes to the renderer in one go instead of per event. */
+    void    FlushDiskStates();
+    void    PushDiskTransforms();
+
+    /**
+     * Re-tier the disk actors around the players: disks whose cell came within NearDiskRadius get
+     * full collision back, ones that left it go query-only. Costs the near cells, not the grid.
+     */
+    void    UpdateDiskSignificance();
+    void    ResetSignificance();
+    void    SetDiskSignificant(int32 Index, bool bNear);
+
+    // Replication: the server writes changed disks into NetDisks; clients apply them.
+    float   GetNetTime() const;
+    void    WriteNetDisk(int32 Index);
+    void    RebuildNetDisks();
+    void    ApplyAllNetDisks();
+    void    GatherPlayers(TArray<FDiskPlayer, TInlineAllocator<32>>& OutPlayers);
+    void    ReleasePlayerSlot(int32 Slot);
+
+    UFUNCTION()
+    void OnRep_GridSize();
+
+    // Knockback for instanced disks (the per-actor path lives in AFallingDisk::OnDiskHit)
+    UFUNCTION()
+    void OnInstancedDiskHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
+        UPrimitiveComponent* OtherComp, FVector NormalImpulse,
+        const FHitResult& Hit);
 
-    void CheckGroundHits();
-    void CheckRedPromotion();
-    void CheckGreenUnfreeze();
     void CheckWinCondition(float PlayerZ);
     void UpdateHUD(float PlayerZ);
     void ShowWinScreen();
+
+    /** Publish the disk-state counters and roll the per-second rates for stat/Insights. */
+    void UpdateStats();
 };
\ No newline at end of file
@@ -6,7 +6,8 @@
 //  Constructor 
 AFallingDisk::AFallingDisk()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Movement is integrated by ADiskSpawner's FDiskSimulation, not per actor.
+    PrimaryActorTick.bCanEverTick = false;
 
     DiskMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DiskMesh"));
     RootComponent = DiskMesh;
@@ -21,17 +22,11 @@ void AFallingDisk::BeginPlay()
 {
     Super::BeginPlay();
     DiskMesh->OnComponentHit.AddDynamic(this, &AFallingDisk::OnDiskHit);
-}
-
-//  Tick 
-void AFallingDisk::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
 
-    // Only move when falling; frozen disks are stationary.
-    if (DiskState == EDiskState::Falling)
+    // The only material assignment this disk gets; from here on the state is one float.
+    if (Mat_Shared)
     {
-        AddActorWorldOffset(FVector(0.f, 0.f, -FallSpeed * DeltaTime));
+        DiskMesh->SetMaterial(0, Mat_Shared);
     }
 }
 
@@ -78,9 +73,27 @@ void AFallingDisk::Respawn(FVector NewLocation, float NewSpeed)
     Initialize(NewSpeed);
 }
 
+void AFallingDisk::SetSignificant(bool bNear)
+{
+    DiskMesh->SetCollisionEnabled(bNear ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::QueryOnly);
+    DiskMesh->SetNotifyRigidBodyCollision(bNear);
+}
+
+bool AFallingDisk::FlushVisualState()
+{
+    if (!Mat_Shared || DrawnState == DiskState) return false;
+
+    // Updates the primitive's shader data in place; SetMaterial would rebuild its render proxy.
+    DrawnState = DiskState;
+    DiskMesh->SetCustomPrimitiveDataFloat(0, static_cast<float>(DiskState));
+    return true;
+}
+
 //  Private 
 void AFallingDisk::ApplyMaterial(UMaterialInterface* Mat)
 {
+    if (Mat_Shared) return;   // DiskState is all FlushVisualState needs
+
     if (Mat && DiskMesh)
     {
         DiskMesh->SetMaterial(0, Mat);
@@ -92,18 +105,22 @@ void AFallingDisk::OnDiskHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
     const FHitResult& Hit)
 {
     // Only falling disks knock the player back.
-    if (DiskState != EDiskState::Falling) return;
+    if (!bKnockbackOnHit || DiskState != EDiskState::Falling) return;
 
-    ACharacter* HitChar = Cast<ACharacter>(OtherActor);
+    ApplyKnockback(Cast<ACharacter>(OtherActor), GetActorLocation(), KnockbackForce);
+}
+
+void AFallingDisk::ApplyKnockback(ACharacter* HitChar, const FVector& DiskLocation, float Force)
+{
     if (!HitChar) return;
 
     UCharacterMovementComponent* Move = HitChar->GetCharacterMovement();
     if (Move && !Move->IsMovingOnGround())
     {
         // Push the player downward and slightly away from the disk center.
-        FVector Dir = (HitChar->GetActorLocation() - GetActorLocation()).GetSafeNormal();
+        FVector Dir = (HitChar->GetActorLocation() - DiskLocation).GetSafeNormal();
         Dir.Z = -0.6f;
-        HitChar->LaunchCharacter(Dir.GetSafeNormal() * KnockbackForce,
+        HitChar->LaunchCharacter(Dir.GetSafeNormal() * Force,
             /*bXYOverride=*/true, /*bZOverride=*/true);
     }
 }
\ No newline at end of file
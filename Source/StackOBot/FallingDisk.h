@@ -2,16 +2,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "DiskFieldTypes.h"
 #include "FallingDisk.generated.h"
 
-//  Disk state 
-UENUM(BlueprintType)
-enum class EDiskState : uint8
-{
-    Falling      UMETA(DisplayName = "Falling"),
-    FrozenRed    UMETA(DisplayName = "Frozen Red  (one above player)"),
-    FrozenGreen  UMETA(DisplayName = "Frozen Green (below player)"),
-};
+class ACharacter;
 
 //  Actor 
 UCLASS()
@@ -26,8 +20,6 @@ protected:
     virtual void BeginPlay() override;
 
 public:
-    virtual void Tick(float DeltaTime) override;
-
     //  Components 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     TObjectPtr<UStaticMeshComponent> DiskMesh;
@@ -49,10 +41,24 @@ public:
     UPROPERTY(EditDefaultsOnly, Category = "Disk|Visuals")
     TObjectPtr<UMaterialInterface> Mat_FrozenGreen;
 
+    /**
+     * One material for every state, reading Custom Primitive Data [0] (0 = Falling, 1 = Red,
+     * 2 = Green) like ADiskSpawner::InstancedDiskMaterial. When set, the three above are unused.
+     */
+    UPROPERTY(EditDefaultsOnly, Category = "Disk|Visuals")
+    TObjectPtr<UMaterialInterface> Mat_Shared;
+
     //  State (read by ADiskSpawner every tick) 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Disk")
     EDiskState DiskState = EDiskState::Falling;
 
+    /** Grid cell this disk occupies; assigned by ADiskSpawner when it spawns the disk. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Disk")
+    int32 CellIndex = INDEX_NONE;
+
+    /** Knock the player back from physics hits; ADiskSpawner clears it when it sweeps for knockback per fixed step. */
+    bool bKnockbackOnHit = true;
+
     //  Public API called by ADiskSpawner 
 
     /** Set starting speed and reset to Falling. Call before placing in the world. */
@@ -73,8 +79,24 @@ public:
     /** Teleport to NewLocation and re-initialize with a new speed (ground respawn). */
     void Respawn(FVector NewLocation, float NewSpeed);
 
+    /**
+     * Near disks block with physics and report hits. Far ones are query-only: traces and
+     * character sweeps still find them, but they make no physics contacts or hit events.
+     */
+    void SetSignificant(bool bNear);
+
+    /**
+     * With Mat_Shared, state changes are only recorded; ADiskSpawner calls this once per disk
+     * after its event pass to write the colour. Returns false if the drawn state was current.
+     */
+    bool FlushVisualState();
+
+    /** Launch an airborne character down and away from DiskLocation. Shared with instanced disks. */
+    static void ApplyKnockback(ACharacter* HitChar, const FVector& DiskLocation, float Force);
+
 private:
     float StoredFallSpeed = 200.f;   // Memorized when frozen; restored on Unfreeze
+    EDiskState DrawnState = EDiskState::Falling;   // Custom primitive data defaults to 0
 
     void ApplyMaterial(UMaterialInterface* Mat);
 
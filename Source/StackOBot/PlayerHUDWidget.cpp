@@ -1,23 +1,43 @@
 #include "PlayerHUDWidget.h"
 #include "Components/TextBlock.h"
+#include "Misc/StringBuilder.h"
 
-void UPlayerHUDWidget::SetBlockText(FName WidgetName, const FString& Text)
+void UPlayerHUDWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    CurrentZText = FindTextBlock(TEXT("Text_CurrentZ"));
+    HighestZText = FindTextBlock(TEXT("Text_HighestZ"));
+    WinGoalText  = FindTextBlock(TEXT("Text_WinGoal"));
+}
+
+UTextBlock* UPlayerHUDWidget::FindTextBlock(FName WidgetName) const
 {
     UTextBlock* TB = Cast<UTextBlock>(GetWidgetFromName(WidgetName));
-    if (TB)
-        TB->SetText(FText::FromString(Text));
+    if (!TB)
+        UE_LOG(LogTemp, Warning, TEXT("PlayerHUDWidget: no TextBlock named %s"), *WidgetName.ToString());
+    return TB;
+}
+
+void UPlayerHUDWidget::SetValueText(UTextBlock* Block, const TCHAR* Prefix, int32 Value, int32& Shown)
+{
+    if (!Block || Value == Shown) return;
+    Shown = Value;
+
+    TStringBuilder<64> Text;
+    Text << Prefix << Value;
+    Block->SetText(FText::FromStringView(Text.ToView()));
 }
 
 void UPlayerHUDWidget::SetGoalText(float GoalHeight)
 {
-    SetBlockText(TEXT("Text_WinGoal"),
-        FString::Printf(TEXT("Reach %.0f to win"), GoalHeight));
+    if (WinGoalText)
+        WinGoalText->SetText(FText::FromString(
+            FString::Printf(TEXT("Reach %d to win"), FMath::RoundToInt32(GoalHeight))));
 }
 
 void UPlayerHUDWidget::UpdateValues(float CurrentZ, float HighestZ)
 {
-    SetBlockText(TEXT("Text_CurrentZ"),
-        FString::Printf(TEXT("Height : %.0f"), CurrentZ));
-    SetBlockText(TEXT("Text_HighestZ"),
-        FString::Printf(TEXT("Best    : %.0f"), HighestZ));
+    SetValueText(CurrentZText, TEXT("Height : "), FMath::RoundToInt32(CurrentZ), ShownCurrentZ);
+    SetValueText(HighestZText, TEXT("Best    : "), FMath::RoundToInt32(HighestZ), ShownHighestZ);
 }
@@ -12,14 +12,37 @@ class STACKOBOT_API UPlayerHUDWidget : public UUserWidget
     GENERATED_BODY()
 
 public:
-    /** Called every tick by ADiskSpawner to refresh both lines. */
+    /**
+     * Called every tick by ADiskSpawner. A line is only reformatted and re-set when its rounded
+     * value changes, so unchanged frames cause no Slate invalidation (the HUD can sit under an
+     * InvalidationBox or RetainerBox and cost nothing while the height holds).
+     */
     void UpdateValues(float CurrentZ, float HighestZ);
 
     /** Called once from BeginPlay to set the static goal line. */
     void SetGoalText(float GoalHeight);
 
+protected:
+    virtual void NativeOnInitialized() override;
+
 private:
-    // Looks up a TextBlock by widget name at runtime — avoids BindWidget
+    // Looked up by widget name once at initialization — avoids BindWidget
     // serialization issues in packaged Shipping builds.
-    void SetBlockText(FName WidgetName, const FString& Text);
+    UPROPERTY()
+    TObjectPtr<UTextBlock> CurrentZText;
+
+    UPROPERTY()
+    TObjectPtr<UTextBlock> HighestZText;
+
+    UPROPERTY()
+    TObjectPtr<UTextBlock> WinGoalText;
+
+    // Last value shown on each line; MIN_int32 forces the first update.
+    int32 ShownCurrentZ = MIN_int32;
+    int32 ShownHighestZ = MIN_int32;
+
+    UTextBlock* FindTextBlock(FName WidgetName) const;
+
+    /** Format Prefix + Value into a stack buffer and set it, if Value differs from Shown. */
+    static void SetValueText(UTextBlock* Block, const TCHAR* Prefix, int32 Value, int32& Shown);
 };
@@ -1,12 +1,13 @@
 #include "ShootingComponent.h"
 #include "DiskSpawner.h"
 #include "FallingDisk.h"
+#include "DiskFieldProfiler.h"
+#include "DiskFieldSubsystem.h"
 
 #include "GameFramework/Character.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "Blueprint/UserWidget.h"
-#include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
 #include "DrawDebugHelpers.h"
@@ -15,6 +16,7 @@
 UShootingComponent::UShootingComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
+    SetIsReplicatedByDefault(true);   // For ServerFire
 }
 
 // ������ BeginPlay ����������������������������������������������������������������������������������������������������������������������������������
@@ -22,6 +24,8 @@ void UShootingComponent::BeginPlay()
 {
     Super::BeginPlay();
 
+    AsyncTraceDelegate.BindUObject(this, &UShootingComponent::OnAsyncTraceDone);
+
     // ���� Find the Spring Arm on the owning character ������������������������������������������������������������
     SpringArm = GetOwner()->FindComponentByClass<USpringArmComponent>();
     if (SpringArm)
@@ -36,17 +40,18 @@ void UShootingComponent::BeginPlay()
     }
 
     // ���� Find the DiskSpawner placed in the level ������������������������������������������������������������������
-    TArray<AActor*> Found;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ADiskSpawner::StaticClass(), Found);
-    if (Found.Num() > 0)
-    {
-        DiskSpawner = Cast<ADiskSpawner>(Found[0]);
-    }
-    else
+    // Registered by the spawner before any BeginPlay; no actor scan needed.
+    DiskSpawner = UDiskFieldSubsystem::FindSpawner(this);
+    if (!DiskSpawner)
     {
         UE_LOG(LogTemp, Warning,
             TEXT("ShootingComponent: No ADiskSpawner found in the level."));
     }
+    else if (GetOwner()->HasAuthority())
+    {
+        // Anyone who can shoot also moves the field's floor and owns a red disk.
+        DiskSpawner->RegisterPlayer(Cast<ACharacter>(GetOwner()));
+    }
 
     // ���� Create crosshair widget (hidden until ADS) ��������������������������������������������������������������
     if (CrosshairWidgetClass)
@@ -60,10 +65,27 @@ void UShootingComponent::BeginPlay()
     }
 }
 
+void UShootingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (DiskSpawner && GetOwner()->HasAuthority())
+        DiskSpawner->UnregisterPlayer(Cast<ACharacter>(GetOwner()));
+
+    // The pooled beams belong to the world, not the owner, so they would outlive it.
+    for (UNiagaraComponent* Beam : BeamPool)
+    {
+        if (Beam) Beam->DestroyComponent();
+    }
+    BeamPool.Empty();
+    NextBeam = 0;
+
+    Super::EndPlay(EndPlayReason);
+}
+
 // ������ Tick ��������������������������������������������������������������������������������������������������������������������������������������������
 void UShootingComponent::TickComponent(float DeltaTime, ELevelTick TickType,
     FActorComponentTickFunction* ThisTickFunction)
 {
+    LLM_SCOPE_BYTAG(StackOBot);
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
     // Smoothly lerp the Spring Arm socket offset into/out of ADS position.
@@ -73,6 +95,14 @@ void UShootingComponent::TickComponent(float DeltaTime, ELevelTick TickType,
         SpringArm->SocketOffset = FMath::VInterpTo(
             SpringArm->SocketOffset, Target, DeltaTime, ADSInterpSpeed);
     }
+
+    // Every shot queued this frame resolves as one.
+    if (bHasPendingShot)
+    {
+        bHasPendingShot = false;
+        DISKFIELD_PHASE_SCOPE(Fire);
+        ResolveShot(PendingShotLoc, PendingShotRot);
+    }
 }
 
 // ������ Input Handlers ������������������������������������������������������������������������������������������������������������������������
@@ -89,35 +119,150 @@ void UShootingComponent::StopADS()
 }
 
 /**
- * Fire performs a hitscan line trace from the camera centre.
- * A debug line is drawn as a placeholder laser; replace it with a Niagara beam
- * once you have set up the VFX asset.
+ * Fire performs a hitscan from the camera centre: the spawner's grid raycast finds the disk,
+ * and an optional world trace up to it lets level geometry block the shot.
  */
 void UShootingComponent::Fire()
 {
+    LLM_SCOPE_BYTAG(StackOBot);
+    DISKFIELD_PHASE_SCOPE(Fire);
+
     APawn* OwnerPawn = Cast<APawn>(GetOwner());
     if (!OwnerPawn) return;
 
-    APlayerController* PC = Cast<APlayerController>(OwnerPawn->GetController());
-    if (!PC) return;
+    // Players shoot from the camera; AI controllers (the soak-test bots) from the pawn's eyes
+    // along their control rotation.
+    AController* Controller = OwnerPawn->GetController();
+    if (!Controller || !ConsumeShot()) return;
 
     // ���� Determine trace start/end from the camera viewpoint ������������������������������������������
     FVector  CamLoc;
     FRotator CamRot;
-    PC->GetPlayerViewPoint(CamLoc, CamRot);
+    Controller->GetPlayerViewPoint(CamLoc, CamRot);
+    DISKFIELD_COUNT(Shots, 1);
+
+    if (bCoalesceShotsPerFrame)
+    {
+        PendingShotLoc  = CamLoc;
+        PendingShotRot  = CamRot;
+        bHasPendingShot = true;
+        return;
+    }
+
+    ResolveShot(CamLoc, CamRot);
+}
+
+void UShootingComponent::ServerFire_Implementation(FVector_NetQuantize CamLoc, FRotator CamRot)
+{
+    LLM_SCOPE_BYTAG(StackOBot);
+    DISKFIELD_PHASE_SCOPE(Fire);
+
+    // The view point comes from the client: only trust it from about where its pawn stands,
+    // and no faster than an honest client's Fire() lets shots through.
+    if (!ConsumeShot()) return;
+    if (!IsPlausibleShotOrigin(CamLoc))
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("ShootingComponent: dropped a shot from %s, %.0f UU from its pawn"),
+            *GetOwner()->GetName(), FVector::Dist(CamLoc, Cast<APawn>(GetOwner())->GetPawnViewLocation()));
+        return;
+    }
+
+    DISKFIELD_COUNT(Shots, 1);
+    ResolveShot(CamLoc, CamRot);
+}
+
+bool UShootingComponent::ConsumeShot()
+{
+    constexpr float Burst = 2.f;
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    ShotTokens     = FMath::Min(ShotTokens + static_cast<float>(Now - ShotTokensTime) * MaxShotsPerSecond, Burst);
+    ShotTokensTime = Now;
+
+    if (ShotTokens < 1.f) return false;
+    ShotTokens -= 1.f;
+    return true;
+}
+
+bool UShootingComponent::IsPlausibleShotOrigin(const FVector& CamLoc) const
+{
+    const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+    if (!OwnerPawn) return false;
+
+    // The camera sits at the end of the spring arm, shifted by whichever socket offset is larger.
+    float Reach = ShotOriginTolerance;
+    if (SpringArm)
+    {
+        Reach += SpringArm->TargetArmLength + SpringArm->TargetOffset.Size()
+            + FMath::Max(DefaultSocketOffset.Size(), ADSSocketOffset.Size());
+    }
+    return FVector::DistSquared(CamLoc, OwnerPawn->GetPawnViewLocation()) <= FMath::Square(Reach);
+}
+
+// ������ Private ��������������������������������������������������������������������������������������������������������������������������������������
+void UShootingComponent::ResolveShot(const FVector& CamLoc, const FRotator& CamRot)
+{
+    // Clients still trace and draw the beam straight away; only the server's hit counts.
+    if (!GetOwner()->HasAuthority())
+        ServerFire(CamLoc, CamRot);
 
     const FVector TraceEnd = CamLoc + CamRot.Vector() * TraceRange;
 
-    FCollisionQueryParams QueryParams;
-    QueryParams.AddIgnoredActor(GetOwner());    // Don't hit ourselves
+    if (bAsyncTrace)
+    {
+        FAsyncShot Shot{ FTraceHandle(), CamLoc, CamRot, INDEX_NONE, TraceEnd,
+            DiskSpawner ? DiskSpawner->GetSimulationTime() : 0.0 };
+
+        FVector WorldTraceEnd;
+        if (BeginShotTrace(CamLoc, TraceEnd, Shot.HitCell, Shot.HitPoint, WorldTraceEnd))
+        {
+            // Runs alongside the rest of the frame; OnAsyncTraceDone picks it up next frame.
+            Shot.Handle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+                CamLoc, WorldTraceEnd, ECC_Visibility, MakeShotQueryParams(),
+                FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate);
+            AsyncShots.Add(Shot);
+            return;
+        }
+
+        FinishShot(CamLoc, CamRot, Shot.HitCell, Shot.HitPoint);
+        return;
+    }
+
+    FVector     HitPoint;
+    const int32 HitCell = TraceShot(CamLoc, TraceEnd, HitPoint);
+    FinishShot(CamLoc, CamRot, HitCell, HitPoint);
+}
+
+void UShootingComponent::OnAsyncTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    LLM_SCOPE_BYTAG(StackOBot);
+    const int32 Slot = AsyncShots.IndexOfByPredicate(
+        [&Handle](const FAsyncShot& Shot) { return Shot.Handle == Handle; });
+    if (Slot == INDEX_NONE) return;
+
+    FAsyncShot Shot = AsyncShots[Slot];
+    AsyncShots.RemoveAtSwap(Slot, EAllowShrinking::No);
 
-    FHitResult Hit;
-    const bool bHit = GetWorld()->LineTraceSingleByChannel(
-        Hit, CamLoc, TraceEnd, ECC_Visibility, QueryParams);
+    const FHitResult* Hit = Datum.OutHits.FindByPredicate(
+        [](const FHitResult& Result) { return Result.bBlockingHit; });
+    ApplyWorldHit(Hit, Shot.HitCell, Shot.HitPoint);
 
+    // The disk the shot was aimed at is no longer there: the beam still fires, the hit doesn't.
+    if (Shot.HitCell != INDEX_NONE && DiskSpawner && DiskSpawner->WasDiskRespawnedSince(Shot.HitCell, Shot.IssueTime))
+        Shot.HitCell = INDEX_NONE;
+
+    DISKFIELD_PHASE_SCOPE(Fire);
+    FinishShot(Shot.CamLoc, Shot.CamRot, Shot.HitCell, Shot.HitPoint);
+}
+
+void UShootingComponent::FinishShot(const FVector& CamLoc, const FRotator& CamRot, int32 HitCell, const FVector& HitPoint)
+{
     // ←─ Niagara laser beam visual ──────────────────────────────────────────────────
-    if (LaserEffect)
+    // A dedicated server has nobody to draw the beam for.
+    if (LaserEffect && GetNetMode() != NM_DedicatedServer)
     {
+        DISKFIELD_PHASE_SCOPE(FireBeam);
+
         // Beam starts at the character's chest/front (visually connected to mesh).
         const FVector BeamStart = GetOwner()->GetActorLocation()
             + GetOwner()->GetActorForwardVector() * 30.f
@@ -126,43 +271,108 @@ void UShootingComponent::Fire()
         // Beam end: project from BeamStart along the CAMERA's forward direction by
         // the hit distance. This keeps the visual beam aligned with the crosshair
         // even though BeamStart != CamLoc (standard third-person technique).
-        const float HitDist = bHit
-            ? FVector::Dist(CamLoc, Hit.ImpactPoint)
-            : TraceRange;
+        const float HitDist = FVector::Dist(CamLoc, HitPoint);
         const FVector BeamEnd = BeamStart + CamRot.Vector() * HitDist;
 
-        UNiagaraComponent* Beam = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-            GetWorld(), LaserEffect, BeamStart);
-        if (Beam)
-        {
-            Beam->SetVectorParameter(FName("BeamEnd"), BeamEnd);
-        }
+        ShowBeam(BeamStart, BeamEnd);
     }
 
     // ���� Notify the spawner if we hit a disk ����������������������������������������������������������������������������
-    if (bHit && DiskSpawner)
+    if (DiskSpawner && GetOwner()->HasAuthority())
+    {
+        if (HitCell != INDEX_NONE)
+            DiskSpawner->NotifyCellHit(HitCell, Cast<ACharacter>(GetOwner()));
+        else
+            DiskSpawner->NotifyShotMissed(Cast<ACharacter>(GetOwner()));
+    }
+}
+
+int32 UShootingComponent::TraceShot(const FVector& CamLoc, const FVector& TraceEnd, FVector& OutHitPoint) const
+{
+    DISKFIELD_PHASE_SCOPE(FireTrace);
+
+    int32 HitCell = INDEX_NONE;
+    OutHitPoint   = TraceEnd;
+
+    FVector WorldTraceEnd;
+    if (BeginShotTrace(CamLoc, TraceEnd, HitCell, OutHitPoint, WorldTraceEnd))
     {
-        AFallingDisk* Disk = Cast<AFallingDisk>(Hit.GetActor());
-        if (Disk)
+        FHitResult Hit;
+        const bool bBlocked = GetWorld()->LineTraceSingleByChannel(
+            Hit, CamLoc, WorldTraceEnd, ECC_Visibility, MakeShotQueryParams());
+        ApplyWorldHit(bBlocked ? &Hit : nullptr, HitCell, OutHitPoint);
+    }
+    return HitCell;
+}
+
+bool UShootingComponent::BeginShotTrace(const FVector& CamLoc, const FVector& TraceEnd,
+    int32& InOutHitCell, FVector& InOutHitPoint, FVector& OutWorldTraceEnd) const
+{
+    if (bUseDiskGridTrace && DiskSpawner)
+    {
+        // Walk only the grid cells under the ray; no physics scene needed to find the disk.
+        FDiskRayHit DiskHit;
+        if (DiskSpawner->RaycastDisks(CamLoc, TraceEnd, DiskHit))
         {
-            DiskSpawner->NotifyDiskHit(Disk, Cast<ACharacter>(GetOwner()));
+            InOutHitCell  = DiskHit.Cell;
+            InOutHitPoint = DiskHit.ImpactPoint;
         }
+
+        // Anything that isn't a disk in front of the hit point blocks the shot and ends the beam.
+        OutWorldTraceEnd = InOutHitPoint;
+        return bCheckShotOcclusion;
     }
+
+    OutWorldTraceEnd = TraceEnd;
+    return true;
 }
 
-// ������ Private ��������������������������������������������������������������������������������������������������������������������������������������
-void UShootingComponent::ShowCrosshair()
+void UShootingComponent::ApplyWorldHit(const FHitResult* Hit, int32& InOutHitCell, FVector& InOutHitPoint) const
 {
-    if (CrosshairWidget && !CrosshairWidget->IsInViewport())
+    if (!Hit) return;
+
+    if (bUseDiskGridTrace && DiskSpawner)
     {
-        CrosshairWidget->AddToViewport();
+        if (DiskSpawner->GetDiskCellFromHit(*Hit) == INDEX_NONE)
+        {
+            InOutHitCell  = INDEX_NONE;
+            InOutHitPoint = Hit->ImpactPoint;
+        }
+        return;
     }
+
+    InOutHitPoint = Hit->ImpactPoint;
+    if (DiskSpawner)
+        InOutHitCell = DiskSpawner->GetDiskCellFromHit(*Hit);
 }
 
-void UShootingComponent::HideCrosshair()
+FCollisionQueryParams UShootingComponent::MakeShotQueryParams() const
 {
-    if (CrosshairWidget && CrosshairWidget->IsInViewport())
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LaserShot));
+    QueryParams.AddIgnoredActor(GetOwner());    // Don't hit ourselves
+    return QueryParams;
+}
+
+void UShootingComponent::ShowBeam(const FVector& BeamStart, const FVector& BeamEnd)
+{
+    static const FName BeamEndParam(TEXT("BeamEnd"));
+
+    // Grow the ring up to BeamPoolSize, then restart the oldest beam instead of spawning.
+    // Spawned in world space so a beam stays put as the shooter moves; EndPlay destroys them.
+    if (BeamPool.Num() < BeamPoolSize)
     {
-        CrosshairWidget->RemoveFromParent();
+        UNiagaraComponent* NewBeam = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+            GetWorld(), LaserEffect, BeamStart, FRotator::ZeroRotator, FVector::OneVector,
+            /*bAutoDestroy=*/false, /*bAutoActivate=*/false);
+        if (!NewBeam) return;
+        BeamPool.Add(NewBeam);
     }
+
+    UNiagaraComponent* Beam = BeamPool[NextBeam];
+    NextBeam = (NextBeam + 1) % FMath::Max(BeamPoolSize, 1);
+    if (!Beam) return;
+
+    Beam->SetWorldLocation(BeamStart);
+    Beam->SetVectorParameter(BeamEndParam, BeamEnd);
+    Beam->Activate(/*bReset=*/true);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
 #include "ShootingComponent.generated.h"
 
 class ADiskSpawner;
@@ -9,6 +10,7 @@ class AFallingDisk;
 class USpringArmComponent;
 class UUserWidget;
 class UNiagaraSystem;
+class UNiagaraComponent;
 
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class STACKOBOT_API UShootingComponent : public UActorComponent
@@ -20,6 +22,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     virtual void TickComponent(float DeltaTime, ELevelTick TickType,
@@ -31,6 +34,14 @@ public:
     UPROPERTY(EditAnywhere, Category = "Shooting")
     float TraceRange = 5000.f;
 
+    /** Resolve the hit disk with ADiskSpawner's grid raycast instead of a physics line trace. */
+    UPROPERTY(EditAnywhere, Category = "Shooting")
+    bool bUseDiskGridTrace = true;
+
+    /** With the grid raycast, still trace the world up to the disk so level geometry blocks the shot. */
+    UPROPERTY(EditAnywhere, Category = "Shooting", meta = (EditCondition = "bUseDiskGridTrace"))
+    bool bCheckShotOcclusion = true;
+
     /** Camera socket offset while aiming down sights (tune Y to shift right). */
     UPROPERTY(EditAnywhere, Category = "Shooting|ADS")
     FVector ADSSocketOffset = FVector(0.f, 80.f, 20.f);
@@ -47,6 +58,42 @@ public:
     UPROPERTY(EditDefaultsOnly, Category = "Shooting")
     TObjectPtr<UNiagaraSystem> LaserEffect;
 
+    /**
+     * Beam components kept alive and reused round-robin instead of spawning one per shot.
+     * Size it to fire rate x beam lifetime; beyond that the oldest beam is restarted early.
+     */
+    UPROPERTY(EditDefaultsOnly, Category = "Shooting|Beam", meta = (ClampMin = "1"))
+    int32 BeamPoolSize = 8;
+
+    /**
+     * Queue Fire() calls and resolve them once per frame in TickComponent: all shots from one
+     * frame share a view point, so they resolve as one trace, one beam and one hit.
+     */
+    UPROPERTY(EditAnywhere, Category = "Shooting")
+    bool bCoalesceShotsPerFrame = false;
+
+    /**
+     * Run the shot's world trace with AsyncLineTraceByChannel and resolve the hit when it
+     * completes next frame, instead of blocking Fire() on it. A shot whose disk respawned while
+     * the trace was in flight is dropped.
+     */
+    UPROPERTY(EditAnywhere, Category = "Shooting")
+    bool bAsyncTrace = false;
+
+    /**
+     * Most shots per second Fire() and the server accept, with a burst of two for shots that
+     * arrive bunched up by network jitter. Anything faster is dropped.
+     */
+    UPROPERTY(EditAnywhere, Category = "Shooting|Network", meta = (ClampMin = "0.1"))
+    float MaxShotsPerSecond = 10.f;
+
+    /**
+     * How far a client's reported camera may be from where the server can place it: the pawn's
+     * eyes plus the spring arm. Covers the lag between the two copies of the pawn.
+     */
+    UPROPERTY(EditAnywhere, Category = "Shooting|Network")
+    float ShotOriginTolerance = 250.f;
+
     // ���� Input handlers (call these from BP_Bot's Event Graph) ��������������������������������������
 
     UFUNCTION(BlueprintCallable, Category = "Shooting")
@@ -71,8 +118,71 @@ private:
     UPROPERTY()
     TObjectPtr<UUserWidget>         CrosshairWidget;
 
+    UPROPERTY()
+    TArray<TObjectPtr<UNiagaraComponent>> BeamPool;
+    int32 NextBeam = 0;
+
+    // Shot queued by Fire() when bCoalesceShotsPerFrame is on
+    bool     bHasPendingShot = false;
+    FVector  PendingShotLoc  = FVector::ZeroVector;
+    FRotator PendingShotRot  = FRotator::ZeroRotator;
+
+    // A shot waiting on its async world trace
+    struct FAsyncShot
+    {
+        FTraceHandle Handle;
+        FVector      CamLoc;
+        FRotator     CamRot;
+        int32        HitCell;     // Grid raycast result, or INDEX_NONE until the trace lands
+        FVector      HitPoint;
+        double       IssueTime;   // Spawner simulation time when fired
+    };
+
+    TArray<FAsyncShot, TInlineAllocator<8>> AsyncShots;   // Rarely more than a frame's worth in flight
+    FTraceDelegate AsyncTraceDelegate;
+
     FVector DefaultSocketOffset = FVector::ZeroVector;
 
+    // Shot rate limit: a token bucket refilled at MaxShotsPerSecond
+    float  ShotTokens     = 0.f;
+    double ShotTokensTime = 0.0;   // World time of the last refill
+
+    /** Take one shot from the bucket; false if the owner is firing faster than MaxShotsPerSecond. */
+    bool ConsumeShot();
+
+    /** Whether a client could have fired from CamLoc, given where the server has its pawn. */
+    bool IsPlausibleShotOrigin(const FVector& CamLoc) const;
+
     void ShowCrosshair();
     void HideCrosshair();
+
+    /** A client's shot, re-resolved on the server, which alone changes disk state. */
+    UFUNCTION(Server, Reliable)
+    void ServerFire(FVector_NetQuantize CamLoc, FRotator CamRot);
+
+    /** Trace, beam and spawner notification for one shot from the given view point. */
+    void ResolveShot(const FVector& CamLoc, const FRotator& CamRot);
+
+    /** Hitscan from CamLoc to TraceEnd. Returns the disk cell hit (or INDEX_NONE) and where the beam stops. */
+    int32 TraceShot(const FVector& CamLoc, const FVector& TraceEnd, FVector& OutHitPoint) const;
+
+    /**
+     * First half of a shot: the grid raycast, if enabled. Returns true if a world trace up to
+     * OutWorldTraceEnd is still needed to finish it.
+     */
+    bool BeginShotTrace(const FVector& CamLoc, const FVector& TraceEnd,
+        int32& InOutHitCell, FVector& InOutHitPoint, FVector& OutWorldTraceEnd) const;
+
+    /** Second half: fold the world trace's blocking hit (or none) into the shot's result. */
+    void ApplyWorldHit(const FHitResult* Hit, int32& InOutHitCell, FVector& InOutHitPoint) const;
+
+    FCollisionQueryParams MakeShotQueryParams() const;
+
+    /** Beam and spawner notification once the hit is known. */
+    void FinishShot(const FVector& CamLoc, const FRotator& CamRot, int32 HitCell, const FVector& HitPoint);
+
+    void OnAsyncTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    /** Restart the next pooled beam component between BeamStart and BeamEnd. */
+    void ShowBeam(const FVector& BeamStart, const FVector& BeamEnd);
 };
\ No newline at end of file
@@ -15,6 +15,8 @@ public class StackOBot : ModuleRules
             "EnhancedInput",    // Enhanced Input system (already a plugin in this project)
             "Niagara",          // VFX for laser beam (already a plugin)
             "UMG",              // Crosshair widget
+            "NetCore",          // Fast array delta replication of the disk field
+            "AIModule",         // Soak-test bots
         });
     }
 }
\ No newline at end of file
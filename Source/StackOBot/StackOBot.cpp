@@ -3,4 +3,7 @@
 #include "StackOBot.h"
 #include "Modules/ModuleManager.h"
 
+UE_TRACE_CHANNEL_DEFINE(StackOBotChannel);
+LLM_DEFINE_TAG(StackOBot);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, StackOBot, "StackOBot" );
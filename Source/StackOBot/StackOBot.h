@@ -3,4 +3,16 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "HAL/LowLevelMemTracker.h"
 
+// `stat StackOBot` in the console; per-phase cycle counters plus disk/shot counters.
+DECLARE_STATS_GROUP(TEXT("StackOBot"), STATGROUP_StackOBot, STATCAT_Advanced);
+
+// Unreal Insights channel for the disk-field phases: run with -trace=cpu,StackOBot.
+UE_TRACE_CHANNEL_EXTERN(StackOBotChannel, STACKOBOT_API);
+
+// Low-level memory tag for the game loop: run with -llm and watch StackOBot under `stat LLM`.
+// A steady frame should leave it flat.
+LLM_DECLARE_TAG_API(StackOBot, STACKOBOT_API);